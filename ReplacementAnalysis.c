@@ -1,10 +1,34 @@
+#define _GNU_SOURCE                                                                     // sched_setaffinity, sched_getcpu and madvise
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include <time.h>
+#if defined(INSTRUMENT) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>                                                                  // __rdtsc for the phase cycle counts
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define HAVE_AVX2                                                                       // compiler can build the AVX2 generator and lockstep paths
+#endif
 
 /********************************************************************************************************************************************************
 * File Name: montecarlo_aih180000.c
 * Author: Anton Horvath
+* Build: gcc -O2 -pthread ReplacementAnalysis.c -lm (add -DINSTRUMENT to dump hot path counters as JSON on the standard error)
+* Usage: ReplacementAnalysis [-n traces] [-t threads] [-s seed] [-w minimum:maximum] [-c hand|oldest] [-i trace]
+*                             [-l mean:deviation:blockLength:blockShift] [-a samples [-e]] [-o]
+*        ReplacementAnalysis -B length[,length...] [-r repetitions[:warmups]] [-F csv|json] [-s seed] [-w minimum:maximum] [-c hand|oldest]
+*        ReplacementAnalysis -x trace < page-numbers.txt
 * Modification History:
     > 10/30/2021 Added normal random number generator
     > 10/30/2021 Added least recently used replacement algorithm
@@ -13,273 +37,2952 @@
     > 10/30/2021 Added detection of value in set method
     > 10/30/2021 Added set shift method for index-based FIFO
     > 10/31/2021 Fixed clock algorithm
+    > 10/16/2026 Added multi-threaded experiment driver with seedable per-trace random streams
+    > 10/16/2026 Added one-pass stack distance LRU engine, working sets now only fill on page faults
+    > 10/16/2026 Replaced linear working set searches with hash tables, LRU victims come from a recency list
+    > 10/16/2026 FIFO uses a circular buffer, Clock keeps its hand between faults (-c oldest keeps the previous sweep)
+    > 10/16/2026 Added trace sources, replacement algorithms stream page numbers from memory or a memory-mapped trace file
+    > 10/16/2026 Replaced the per-reference polar generator with a batch Philox4x32-10/Box-Muller trace generator (AVX2 when available)
+    > 10/16/2026 Added lockstep FIFO and Clock engines that simulate every working set size in one pass over the trace
+    > 10/16/2026 Added Belady's optimal replacement algorithm as a lower bound, driven by a precomputed next reference array
+    > 10/16/2026 Added benchmark mode (-B) timing every engine and the trace generator, output as CSV or JSON
+    > 10/16/2026 Added compile-time instrumentation (-DINSTRUMENT) of hits, misses, probe lengths, sweep lengths and phase cycles
+    > 10/16/2026 Added approximate LRU mode (-a) estimating the fault curve from a fixed-size SHARDS sample, -e reports its error
 * Procedures:
-* main                - creates resultant arrays, iterates 1000 times representing 1000 experiments. Generates 1000 page numbers for each experiment.
-                        Uses generated data set to loop between working set sizes 4-20, capturing the number of page faults for each replacement
-                        algorithm before saving it to the resultant arrays created earlier. Loops over each possible working set size and ouputs
-                        results
+* main                - parses the command line, splits the experiments (or the working set sizes of a replayed trace file) between worker
+                        threads and sums each worker's LRU histogram, FIFO, Clock and OPT results before outputting them for every working set
+                        size
+* runWorker           - thread body. Claims chunks of traces from a shared counter, generates each trace from the seed and trace number, adds the
+                        trace's stack distances to the worker's LRU histogram and the page faults of FIFO, Clock and OPT for each working set
+                        size to the worker's resultant arrays
+* replayWorker        - thread body. Claims the LRU pass, a lockstep pass or a working set size of a replayed trace file from a shared counter
+                        and adds its page faults to the worker's histogram or resultant arrays
+* runBenchmark        - times every replacement engine and the trace generator over generated traces of each requested length
+* timeTarget          - runs one benchmark target once and returns the nanoseconds it took
+* reportTarget        - outputs the statistics of one benchmark target as a CSV row or JSON object
+* pinThread           - pins the calling thread to the processor it is running on
 * LRU                 - gets the number of page faults generated from a least-recently-used strategy
-* hasValue            - returns the index of the given value in a set, -1 if not found
-* getMinimumIndex     - returns the minimum value in a given set
 * FIFO                - gets the number of page faults generated from a first-in-first-out strategy
-* replace             - shifts values over in a given set at a given index to ensure index-based FIFO is valid
 * Clock               - gets the number of page faults generated from a clock strategy
-* getClockIndex       - iterates over values in a use-bit set and decrements if not 0. Returns first 0's index
+* OPT                 - gets the number of page faults generated from Belady's optimal strategy
+* getClockIndex       - moves the clock hand over a use-bit set, decrementing if not 0. Returns first 0's index
+* getOldestClockIndex - iterates over a use-bit set from the oldest page and decrements if not 0. Returns first 0's index
+* findNextReferences  - stores the time of the next reference to the same page for every page number of a data set
+* createLockstep      - allocates the frames of one configuration per working set size, laid out back to back
+* resetLockstep       - empties the working set of every lockstep configuration
+* freeLockstep        - releases the state of a lockstep simulation
+* lockstepFIFO        - gets the FIFO page faults of every working set size from one pass over the data set
+* lockstepClock       - gets the Clock page faults of every working set size from one pass over the data set
+* matchFrames         - marks every frame of every configuration holding a page number
+* matchFramesAVX2     - marks every frame of every configuration holding a page number with AVX2
+* missedConfigurations - returns the configurations missing the page number matched last
+* createRecencyList   - allocates an empty list of frames ordered from least to most recently used
+* appendFrame         - links a frame as the most recently used one
+* unlinkFrame         - takes a frame out of a recency list
+* freeRecencyList     - releases a recency list
+* createNextUseHeap   - allocates an empty heap of frames ordered by the next reference to their page
+* pushFrame           - adds a frame to a next use heap
+* updateFrame         - changes the next reference of a frame in a next use heap
+* freeNextUseHeap     - releases a next use heap
+* stackDistances      - adds the LRU stack distance of every reference in a data set to a histogram in a single pass
+* getHistogramFaults  - returns the number of LRU page faults for a working set size from a stack distance histogram
+* createHistogram     - allocates an empty stack distance histogram
+* freeHistogram       - releases a stack distance histogram
+* sampleDistances     - adds the scaled LRU stack distances of a hashed sample of the pages of a data set to a sampled histogram
+* getSampledFaults    - returns the estimated number of LRU page faults for a working set size from a sampled histogram
+* createSampledHistogram - allocates an empty sampled stack distance histogram
+* freeSampledHistogram - releases a sampled stack distance histogram
+* sampleHash          - returns the hash deciding whether a page number is sampled
+* createSampleHeap    - allocates an empty heap of sampled pages ordered by hash
+* pushSample          - adds a sampled page to a sample heap
+* popSample           - removes and returns the sampled page with the largest hash
+* freeSampleHeap      - releases a sample heap
+* createPageTable     - allocates an empty page number hash table
+* getHomeSlot         - gets the slot a page number's probe run starts from
+* findPage            - returns the value stored for a page number in a hash table, NULL if not found
+* insertPage          - stores a value for a page number that is not yet in a hash table
+* removePage          - removes a page number from a hash table
+* freePageTable       - releases a page number hash table
+* compactTimes        - renumbers the reference times of a stack distance pass so its Fenwick tree never grows with the trace length
+* openMemoryTrace     - creates a trace source over page numbers already in memory
+* openTraceFile       - creates a trace source over a memory-mapped trace file
+* readTrace           - returns the next block of page numbers of a trace source
+* rewindTrace         - moves a trace source back to its first page number
+* closeTrace          - releases a trace source
+* convertTrace        - encodes page numbers read as text into a trace file
+* generateTrace       - fills a data set with normally distributed page numbers following a locality model
+* philoxBlocks        - generates groups of Philox4x32-10 random blocks
+* philoxBlocksAVX2    - generates the same groups of Philox4x32-10 random blocks with AVX2
+* boxMuller           - turns groups of Philox blocks into pairs of normally distributed numbers
+* boxMullerAVX2       - turns groups of Philox blocks into the same normally distributed numbers with AVX2
+* startPass           - forgets the pages seen by the calling thread's previous pass over a trace (INSTRUMENT)
+* markReference       - records whether a page number is the first reference to its page in the current pass (INSTRUMENT)
+* countProbes         - records the probe length of a page table lookup (INSTRUMENT)
+* readCycles          - returns the processor's time stamp counter (INSTRUMENT)
+* addCounters         - adds one thread's counters to another set of counters (INSTRUMENT)
+* dumpCounters        - outputs counters as a JSON object (INSTRUMENT)
 ********************************************************************************************************************************************************/
 
-double normal (double mu, double sigma);
-int LRU(int size, int data []);
-int hasValue (int value, int set [], int size);
-int getMinimumIndex (int counters [], int size);
-int FIFO(int size, int *data);
-void replace(int startingIndex, int set [], int size, int value);
-int Clock(int size, int *data);
-int getClockIndex(int size, int *useBits);
+#define TRACE_LENGTH 1000                                                               // number of page references in every generated trace
+#define MIN_WSS 4                                                                       // default smallest working set size simulated
+#define MAX_WSS 20                                                                      // default largest working set size simulated
+#define TRACE_CHUNK 16                                                                  // number of traces a worker claims from the shared counter at once
+#define CLOCK_HAND 0                                                                    // Clock mode, hand stays where the previous fault left it
+#define CLOCK_OLDEST_FIRST 1                                                            // Clock mode, every fault sweeps from the oldest page
+#define LOCKSTEP_MAX_WSS 32                                                             // largest working set size simulated by the lockstep engines
+#define NEVER LLONG_MAX                                                                 // next reference time of a page that is not referenced again
+#define SAMPLE_SPACE 4294967296.0                                                       // number of possible sample hashes, a page is sampled
+                                                                                        // when its hash is below the threshold
+#define ESTIMATE_SCALE 1048576                                                          // approximate LRU faults are summed in 2^-20 faults, as
+                                                                                        // integers so the total does not depend on the order
+#define BENCHMARK_CSV 0                                                                 // benchmark output format, one comma separated row per target
+#define BENCHMARK_JSON 1                                                                // benchmark output format, an array of one object per target
+#define BENCHMARK_MAX_LENGTHS 16                                                        // most trace lengths one benchmark run accepts
+#define TARGET_GENERATE 0                                                               // benchmark targets, see targetNames
+#define TARGET_STACK 1
+#define TARGET_LOCKSTEP_FIFO 2
+#define TARGET_LOCKSTEP_CLOCK 3
+#define TARGET_NEXT_REFERENCES 4
+#define TARGET_LRU 5                                                                    // targets from here on run once per working set size
+#define TARGET_FIFO 6
+#define TARGET_CLOCK 7
+#define TARGET_OPT 8
+#define TARGETS 9
+#define POLICY_STACK 0                                                                  // instrumented policies, see policyNames
+#define POLICY_LRU 1
+#define POLICY_FIFO 2
+#define POLICY_CLOCK 3
+#define POLICY_OPT 4
+#define POLICIES 5
+#define PHASE_GENERATE 0                                                                // instrumented phases of a worker, see phaseNames
+#define PHASE_STACK 1
+#define PHASE_FIFO 2
+#define PHASE_CLOCK 3
+#define PHASE_NEXT_REFERENCES 4
+#define PHASE_OPT 5
+#define PHASE_SAMPLE 6
+#define PHASES 7
+#define PROBE_BUCKETS 8                                                                 // probe lengths 1..7 counted apart, longer ones together
+#define TRACE_BLOCK 4096                                                                // most page numbers a trace source hands out per read
+#define TRACE_MAGIC "MCTRACE1"                                                          // first 8 bytes of a trace file, followed by the 8 byte
+#define TRACE_HEADER 16                                                                 // little-endian reference count and the encoded references
+#define GENERATOR_LANES 8                                                               // Philox blocks generated side by side, one per AVX2 lane
+#define GENERATOR_GROUPS 32                                                             // groups of lanes generated per batch
+#define PHILOX_M0 0xD2511F53u                                                           // Philox4x32 round multipliers
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u                                                           // Philox4x32 key bumps
+#define PHILOX_W1 0xBB67AE85u
+#define LN2_HIGH 6.93147180369123816490e-01                                             // ln 2 split in two, exponent * LN2_HIGH is exact
+#define LN2_LOW 1.90821492927058770002e-10
+#define SQRT2_BITS 0x3FF6A09E667F3BCDull                                                // bit pattern of sqrt(2), larger mantissas are halved
+#ifndef M_PI
+#define M_PI 3.14159265358979323846                                                     // not provided by every math.h in strict C modes
+#endif
+
+typedef struct {
+    double mean;                                                                        // mean page number of the first block of references
+    double deviation;                                                                   // standard deviation of every page number
+    int blockLength;                                                                    // number of references sharing the same mean
+    double blockShift;                                                                  // added to the mean for every later block
+} LocalityModel;
+
+typedef struct {
+    int *keys;                                                                          // page numbers stored in the table
+    int *values;                                                                        // value stored for each page number (parallel array to keys)
+    unsigned char *used;                                                                // flag that indicates a slot holds a page number
+    int capacity;                                                                       // number of slots, always a power of 2
+    int shift;                                                                          // 32 - log2(capacity), keeps the top bits of a hash
+    int count;                                                                          // number of page numbers stored
+} PageTable;
+
+typedef struct {
+    int *older;                                                                         // older[frame] - next less recently used frame, -1 if none
+    int *newer;                                                                         // newer[frame] - next more recently used frame, -1 if none
+    int oldest;                                                                         // least recently used frame, -1 if the list is empty
+    int newest;                                                                         // most recently used frame, -1 if the list is empty
+} RecencyList;
+
+typedef struct {
+    int *heap;                                                                          // frames in max-heap order, heap[0] is referenced furthest ahead
+    int *positions;                                                                     // positions[frame] - index of the frame within heap
+    long long *keys;                                                                    // keys[frame] - time of the next reference to the frame's page
+    int count;                                                                          // number of frames in the heap
+} NextUseHeap;
+
+typedef struct {
+    int configurations;                                                                 // number of working set sizes simulated together, at most 64
+    int *sizes;                                                                         // working set size of every configuration
+    int *offsets;                                                                       // first frame of every configuration within frames
+    unsigned char *owners;                                                              // configuration every frame belongs to
+    int *filled;                                                                        // frames holding a page, per configuration
+    int *hands;                                                                         // FIFO head or clock hand, per configuration
+    int words;                                                                          // number of 64 frame words covering all frames
+    int *frames;                                                                        // frames of every configuration back to back
+    int *useBits;                                                                       // use-bit of every frame (parallel array to frames)
+    uint64_t *valid;                                                                    // bit set for every frame holding a page
+    uint64_t *hits;                                                                     // bit set for every frame holding the page matched last
+    int useAVX2;                                                                        // flag that indicates matchFramesAVX2 can be used
+} Lockstep;
+
+typedef struct {
+    int maxFrames;                                                                      // largest working set size with its own bucket
+    long long *reuse;                                                                   // reuse[d] - re-references at stack distance d, d = maxFrames+1 holds
+                                                                                        // every larger distance
+    long long *first;                                                                   // first[j] - first references to the j-th distinct page of a trace,
+                                                                                        // j = maxFrames+1 holds every later distinct page
+} StackHistogram;
+
+typedef struct {
+    int maxFrames;                                                                      // largest working set size with its own bucket
+    double *reuse;                                                                      // reuse[d] - sampled re-references at scaled stack distance d,
+                                                                                        // d = maxFrames+1 holds every larger distance
+    double *first;                                                                      // first[j] - sampled first references to about the j-th
+                                                                                        // distinct page, j = maxFrames+1 holds every later one
+    double rate;                                                                        // sampling rate the buckets are scaled to
+    long long references;                                                               // page numbers of the data set, most faults an estimate has
+} SampledHistogram;
+
+typedef struct {
+    uint32_t *hashes;                                                                   // sample hash of every page, in max-heap order
+    int *pages;                                                                         // sampled page numbers (parallel array to hashes)
+    int count;                                                                          // number of sampled pages in the heap
+} SampleHeap;
+
+typedef struct {
+    const int *data;                                                                    // page numbers of an in-memory trace, NULL for a trace file
+    const unsigned char *bytes;                                                         // memory-mapped trace file, NULL for an in-memory trace
+    size_t size;                                                                        // number of bytes mapped
+    size_t offset;                                                                      // offset of the next encoded page number in the file
+    long long length;                                                                   // number of page numbers in the trace
+    long long position;                                                                 // number of page numbers already read
+    int previous;                                                                       // page number last decoded, the next delta applies to it
+    int block[TRACE_BLOCK];                                                             // page numbers decoded by the latest read of a file
+} TraceSource;
+
+typedef struct {
+    int traces;                                                                         // total number of experiments shared by all workers
+    uint64_t seed;                                                                      // seed every trace's page numbers are generated from
+    LocalityModel locality;                                                             // distribution of the generated page numbers
+    int minWss;                                                                         // smallest working set size simulated
+    int maxWss;                                                                         // largest working set size simulated
+    int clockMode;                                                                      // CLOCK_HAND or CLOCK_OLDEST_FIRST
+    int lockstepFIFO;                                                                   // flag that indicates FIFO runs all sizes in one pass
+    int lockstepClock;                                                                  // flag that indicates Clock runs all sizes in one pass
+    TraceSource *replay;                                                                // trace file being replayed, NULL to generate traces
+    long long *nextReferences;                                                          // next reference of every page number of the replayed trace
+    int sampleBudget;                                                                   // most pages sampled for approximate LRU, 0 for exact
+    int checkSamples;                                                                   // flag that indicates exact LRU also runs to measure the error
+    int replayOPT;                                                                      // flag that indicates OPT runs on a replayed trace file
+    atomic_llong nextTrace;                                                             // shared counter handing out the next unclaimed trace,
+                                                                                        // 64 bits so claims past the last trace cannot overflow
+} Experiment;
+
+#ifdef INSTRUMENT
+typedef struct {
+    long long hits[POLICIES];                                                           // references finding their page resident
+    long long faults[POLICIES];                                                         // misses replacing a page, the results reported
+    long long compulsory[POLICIES];                                                     // misses on the first reference to a page in a pass
+    long long capacity[POLICIES];                                                       // misses on a page referenced before in the pass
+    long long lookups;                                                                  // findPage calls
+    long long probes;                                                                   // slots probed by all findPage calls
+    long long longestProbe;                                                             // most slots probed by a single findPage call
+    long long probeLengths[PROBE_BUCKETS];                                              // probeLengths[n] - lookups probing n slots, the last
+                                                                                        // bucket holds every longer probe
+    long long sweeps;                                                                   // clock hand sweeps, one per Clock fault
+    long long sweepSteps;                                                               // frames passed over by all sweeps
+    long long longestSweep;                                                             // most frames passed over by a single sweep
+    long long sweep;                                                                    // frames passed over by the sweep in progress
+    unsigned long long cycles[PHASES];                                                  // time stamp counter cycles spent in every phase
+    long long phaseRuns[PHASES];                                                        // number of times every phase ran
+    unsigned long long phaseStart[PHASES];                                              // time stamp counter when the phase last started
+    PageTable seen;                                                                     // pages referenced in the current pass
+    int firstReference;                                                                 // flag that indicates the page marked last is new
+} Counters;
+
+const char *policyNames[POLICIES] = { "stack", "LRU", "FIFO", "Clock", "OPT" };
+const char *phaseNames[PHASES] = { "generate", "stack", "FIFO", "Clock", "nextReferences", "OPT", "sample" };
+_Thread_local Counters *counters;                                                       // counters of the calling thread, NULL when not counted
+#endif
+
+typedef struct {
+    Experiment *experiment;                                                             // experiment the worker takes traces from
+    StackHistogram LRUHistogram;                                                        // this worker's LRU stack distances over all its traces
+    long long *FIFOResults;                                                             // this worker's FIFO page faults for each working set
+    long long *ClockResults;                                                            // this worker's Clock page faults for each working set
+    long long *OPTResults;                                                              // this worker's OPT page faults for each working set
+    long long *LRUEstimates;                                                            // this worker's approximate LRU page faults for each working set,
+                                                                                        // in 1/ESTIMATE_SCALE faults
+#ifdef INSTRUMENT
+    Counters counters;                                                                  // this worker's hot path counters
+#endif
+} Worker;
+
+typedef struct {
+    long long lengths[BENCHMARK_MAX_LENGTHS];                                           // trace lengths benchmarked, one after another
+    int lengthCount;                                                                    // number of trace lengths, 0 outside benchmark mode
+    int repetitions;                                                                    // timed runs of every target
+    int warmups;                                                                        // untimed runs of every target before the timed ones
+    int format;                                                                         // BENCHMARK_CSV or BENCHMARK_JSON
+    int reported;                                                                       // number of targets output so far
+    int *data;                                                                          // generated trace of the length being benchmarked
+    long long length;                                                                   // number of page numbers in data
+    TraceSource source;                                                                 // trace source reading data
+    long long *nextReferences;                                                          // next reference array of data, for OPT
+    StackHistogram histogram;                                                           // stack distances of the latest stack pass
+    Lockstep lockstep;                                                                  // state of the lockstep engines
+    long long *faults;                                                                  // page faults of every working set size of a lockstep pass
+} Benchmark;
+
+const char *targetNames[TARGETS] = { "generate", "stack", "lockstepFIFO", "lockstepClock", "nextReferences", "LRU", "FIFO", "Clock", "OPT" };
+const double logCoefficients[7] = { 6.666666666666735130e-01, 3.999999999940941908e-01, 2.857142874366239149e-01, 2.222219843214978396e-01,
+                                    1.818357216161805012e-01, 1.531383769920937332e-01, 1.479819860511658591e-01 };   // fdlibm log kernel
+const double sinCoefficients[6] = { -1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04,
+                                    2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10 }; // fdlibm sin kernel
+const double cosCoefficients[6] = { 4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+                                    -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11 };   // fdlibm cos kernel
+
+void *runWorker(void *argument);
+void *replayWorker(void *argument);
+int runBenchmark(Experiment *experiment, Benchmark *benchmark);
+double timeTarget(Experiment *experiment, Benchmark *benchmark, int target, int size, long long *faults);
+void reportTarget(Benchmark *benchmark, int target, const char *sizes, double *samples, long long faults);
+void pinThread(void);
+long long LRU(int size, TraceSource *trace, long long length);
+long long FIFO(int size, TraceSource *trace, long long length);
+long long Clock(int size, TraceSource *trace, long long length, int mode);
+long long OPT(int size, TraceSource *trace, long long length, const long long *nextReferences);
+int getClockIndex(int size, int *useBits, int *hand);
+int getOldestClockIndex(RecencyList *arrival, int *useBits);
+void findNextReferences(TraceSource *trace, long long length, long long *nextReferences);
+int createLockstep(Lockstep *lockstep, int minSize, int maxSize);
+void resetLockstep(Lockstep *lockstep);
+void freeLockstep(Lockstep *lockstep);
+void lockstepFIFO(Lockstep *lockstep, TraceSource *trace, long long length, long long *faults);
+void lockstepClock(Lockstep *lockstep, TraceSource *trace, long long length, long long *faults);
+void matchFrames(Lockstep *lockstep, int page);
+#ifdef HAVE_AVX2
+void matchFramesAVX2(Lockstep *lockstep, int page);
+#endif
+uint64_t missedConfigurations(Lockstep *lockstep, int *useBits);
+int createRecencyList(RecencyList *list, int size);
+void appendFrame(RecencyList *list, int frame);
+void unlinkFrame(RecencyList *list, int frame);
+void freeRecencyList(RecencyList *list);
+int createNextUseHeap(NextUseHeap *heap, int size);
+void pushFrame(NextUseHeap *heap, int frame, long long key);
+void updateFrame(NextUseHeap *heap, int frame, long long key);
+void freeNextUseHeap(NextUseHeap *heap);
+void stackDistances(TraceSource *trace, long long length, StackHistogram *histogram);
+long long getHistogramFaults(StackHistogram *histogram, int size);
+int createHistogram(StackHistogram *histogram, int maxFrames);
+void freeHistogram(StackHistogram *histogram);
+void sampleDistances(TraceSource *trace, long long length, int budget, SampledHistogram *histogram);
+double getSampledFaults(SampledHistogram *histogram, int size);
+int createSampledHistogram(SampledHistogram *histogram, int maxFrames);
+void freeSampledHistogram(SampledHistogram *histogram);
+uint32_t sampleHash(int page);
+int createSampleHeap(SampleHeap *heap, int size);
+void pushSample(SampleHeap *heap, uint32_t hash, int page);
+int popSample(SampleHeap *heap);
+void freeSampleHeap(SampleHeap *heap);
+int createPageTable(PageTable *table, int expected);
+unsigned getHomeSlot(PageTable *table, int page);
+int *findPage(PageTable *table, int page);
+void insertPage(PageTable *table, int page, int value);
+void removePage(PageTable *table, int page);
+void freePageTable(PageTable *table);
+int *compactTimes(PageTable *lastReference, int *tree, int *capacity);
+void openMemoryTrace(TraceSource *trace, const int *data, long long length);
+int openTraceFile(TraceSource *trace, const char *path);
+int readTrace(TraceSource *trace, const int **block, long long limit);
+void rewindTrace(TraceSource *trace);
+void closeTrace(TraceSource *trace);
+int convertTrace(FILE *input, const char *path);
+void generateTrace(int *data, int length, LocalityModel *model, uint64_t seed, uint64_t trace);
+void philoxBlocks(uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace);
+void boxMuller(const uint32_t *words, int groups, double *normals);
+#ifdef HAVE_AVX2
+void philoxBlocksAVX2(uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace);
+void boxMullerAVX2(const uint32_t *words, int groups, double *normals);
+#endif
+#ifdef INSTRUMENT
+void startPass(void);
+void markReference(int page);
+void countProbes(long long length);
+unsigned long long readCycles(void);
+void addCounters(Counters *total, Counters *thread);
+void dumpCounters(FILE *output, Counters *thread);
+
+#define COUNT_PASS() startPass()                                                        // a policy starts reading a trace from the front
+#define COUNT_REFERENCE(page) markReference(page)                                       // a policy reads a page number
+#define COUNT_HITS(policy, count) do { if (counters != NULL) { counters->hits[policy] += (count); } } while (0)
+#define COUNT_MISS(policy) do { if (counters != NULL) { \
+        if (counters->firstReference) { counters->compulsory[policy]++; } else { counters->capacity[policy]++; } } } while (0)
+#define COUNT_FAULT(policy) do { if (counters != NULL) { counters->faults[policy]++; } } while (0)
+#define COUNT_PROBES(length) countProbes(length)
+#define COUNT_SWEEP_STEP() do { if (counters != NULL) { counters->sweep++; } } while (0)
+#define COUNT_SWEEP_END() do { if (counters != NULL) { counters->sweeps++; counters->sweepSteps += counters->sweep; \
+        if (counters->sweep > counters->longestSweep) { counters->longestSweep = counters->sweep; } counters->sweep = 0; } } while (0)
+#define PHASE_BEGIN(phase) do { if (counters != NULL) { counters->phaseStart[phase] = readCycles(); } } while (0)
+#define PHASE_END(phase) do { if (counters != NULL) { counters->cycles[phase] += readCycles() - counters->phaseStart[phase]; \
+        counters->phaseRuns[phase]++; } } while (0)
+#else                                                                                   // not instrumented, every counter compiles to nothing
+#define COUNT_PASS() ((void) 0)
+#define COUNT_REFERENCE(page) ((void) 0)
+#define COUNT_HITS(policy, count) ((void) 0)
+#define COUNT_MISS(policy) ((void) 0)
+#define COUNT_FAULT(policy) ((void) 0)
+#define COUNT_PROBES(length) ((void) 0)
+#define COUNT_SWEEP_STEP() ((void) 0)
+#define COUNT_SWEEP_END() ((void) 0)
+#define PHASE_BEGIN(phase) ((void) 0)
+#define PHASE_END(phase) ((void) 0)
+#endif
 
 /********************************************************************************************************************************************************
 * int main (int argc, char *argv[])
 * Author: Anton Horvath
 * Date: 30 October 2021
-* Description:  creates resultant arrays, iterates 1000 times representing 1000 experiments. Generates 1000 page numbers for each experiment.
-                Uses generated data set to loop between working set sizes 4-20, capturing the number of page faults for each replacement
-                algorithm before saving it to the resultant arrays created earlier. Loops over each possible working set size and ouputs
-                results
+* Description:  parses the command line, starts one worker thread per requested thread and lets them share the experiments (1000 by default).
+                Once every worker is joined, their LRU histograms and resultant arrays are summed and the page faults of each replacement
+                algorithm are output for every working set size (4-20 by default). Every trace is generated from the seed and the trace number
+                alone, so the output for a given seed is the same no matter how many threads run. With -i the page numbers are
+                replayed from a trace file instead and the workers share its working set sizes, with -x page numbers read as text from the
+                standard input are converted into a trace file. FIFO and Clock (CLOCK_HAND) simulate all working set sizes in one lockstep pass
+                when none is larger than LOCKSTEP_MAX_WSS, otherwise one size at a time. OPT is reported as the lower bound the other
+                algorithms are measured against. A replayed trace file only runs OPT with -o, since its next reference array takes 8 bytes per
+                reference in memory; it is then built once here and shared by the workers.
+                With -B nothing is summed, the engines are timed on a single pinned thread instead (see runBenchmark). With -a only LRU runs,
+                estimated from a SHARDS sample of at most the given number of pages per pass, and -e adds the exact LRU faults and the miss
+                ratio error of the estimate for every working set size. Built with INSTRUMENT, the counters of the main thread and of every
+                worker are output as JSON on the standard error before returning
 * Parameters:
 *    argc - int - number of arguments sent from the command line
-*    argv - char*[] - arguments sent from the command line
+*    argv - char*[] - arguments sent from the command line (-n traces, -t threads, -s seed, -w smallest:largest working set size,
+                      -c Clock mode, -i trace file to replay, -x trace file to create, -l locality model of generated traces,
+                      -B trace lengths to benchmark, -r benchmark repetitions and warmups, -F benchmark output format,
+                      -a pages sampled for approximate LRU, -e measure the error of approximate LRU, -o run OPT on a replayed trace file)
 ********************************************************************************************************************************************************/
 
 int main(int argc, char *argv[]) {
-    int data[1000];                                                                     // data set which will store all page numbers for the experiments
-    int LRUResults[17];                                                                 // result set which will store LRU results for each working set
-    int FIFOResults[17];                                                                // result set which will store FIFO results for each working set
-    int ClockResults[17];                                                               // result set which will store Clock results for each working set
-    for (int trace = 0; trace < 1000; trace++) {                                        // iterate over 1000 experiments, creating 1000 unique traces
+    Experiment experiment = { .traces = 1000, .seed = 1, .minWss = MIN_WSS, .maxWss = MAX_WSS, .clockMode = CLOCK_HAND,
+                              .locality = { .mean = 10, .deviation = 2, .blockLength = 100, .blockShift = 10 } };
+    LocalityModel *locality = &experiment.locality;
+    int threads = (int) sysconf(_SC_NPROCESSORS_ONLN);                                  // default to one worker thread per online core
+    const char *replayPath = NULL;                                                      // trace file to replay instead of generating traces
+    Benchmark benchmark = { .repetitions = 10, .warmups = 2, .format = BENCHMARK_CSV };
+#ifdef INSTRUMENT
+    Counters mainCounters = { 0 };                                                      // counters of the replay next reference pass or benchmark
+    counters = &mainCounters;
+#endif
+    int option;
+    while ((option = getopt(argc, argv, "n:t:s:w:c:i:x:l:B:r:F:a:eo")) != -1) {         // read command line options
+        if (option == 'n') { experiment.traces = atoi(optarg); }
+        else if (option == 't') { threads = atoi(optarg); }
+        else if (option == 's') { experiment.seed = strtoull(optarg, NULL, 0); }
+        else if (option == 'w' && sscanf(optarg, "%d:%d", &experiment.minWss, &experiment.maxWss) == 2) { }
+        else if (option == 'c' && strcmp(optarg, "hand") == 0) { experiment.clockMode = CLOCK_HAND; }
+        else if (option == 'c' && strcmp(optarg, "oldest") == 0) { experiment.clockMode = CLOCK_OLDEST_FIRST; }
+        else if (option == 'i') { replayPath = optarg; }
+        else if (option == 'l' && sscanf(optarg, "%lf:%lf:%d:%lf", &locality->mean, &locality->deviation,
+                                         &locality->blockLength, &locality->blockShift) == 4) { }
+        else if (option == 'x') { return convertTrace(stdin, optarg) == 0 ? 0 : 1; }    // only convert the page numbers, nothing is simulated
+        else if (option == 'B') {                                                       // comma separated trace lengths
+            for (char *length = strtok(optarg, ","); length != NULL; length = strtok(NULL, ",")) {
+                if (benchmark.lengthCount == BENCHMARK_MAX_LENGTHS) { break; }
+                benchmark.lengths[benchmark.lengthCount++] = strtoll(length, NULL, 0);
+            }
+        }
+        else if (option == 'r' && sscanf(optarg, "%d:%d", &benchmark.repetitions, &benchmark.warmups) >= 1) { }
+        else if (option == 'F' && strcmp(optarg, "csv") == 0) { benchmark.format = BENCHMARK_CSV; }
+        else if (option == 'F' && strcmp(optarg, "json") == 0) { benchmark.format = BENCHMARK_JSON; }
+        else if (option == 'a') { experiment.sampleBudget = atoi(optarg); }
+        else if (option == 'e') { experiment.checkSamples = 1; }
+        else if (option == 'o') { experiment.replayOPT = 1; }
+        else {
+            fprintf(stderr, "usage: %s [-n traces] [-t threads] [-s seed] [-w minimum:maximum] [-c hand|oldest] [-i trace]\n"
+                            "       %*s [-l mean:deviation:blockLength:blockShift] [-a samples [-e]] [-o]\n"
+                            "       %s -B length[,length...] [-r repetitions[:warmups]] [-F csv|json]\n"
+                            "       %s -x trace < page-numbers.txt\n", argv[0], (int) strlen(argv[0]), "", argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if (experiment.traces < 0 || threads < 1 || experiment.minWss < 1 || experiment.maxWss < experiment.minWss) {
+        fprintf(stderr, "%s: traces must be >= 0, threads >= 1 and working set sizes 1 <= minimum <= maximum\n", argv[0]);
+        return 1;
+    }
+    if (locality->deviation < 0 || locality->blockLength < 1) {
+        fprintf(stderr, "%s: locality deviation must be >= 0 and block length >= 1\n", argv[0]);
+        return 1;
+    }
+    if (experiment.sampleBudget < 0 || (experiment.checkSamples && experiment.sampleBudget == 0)) {
+        fprintf(stderr, "%s: samples must be >= 1, -e needs -a\n", argv[0]);
+        return 1;
+    }
+    int sizes = experiment.maxWss - experiment.minWss + 1;                              // number of working set sizes, length of resultant arrays
+    experiment.lockstepFIFO = experiment.maxWss <= LOCKSTEP_MAX_WSS;                    // small working sets are cheaper to compare all at once
+    experiment.lockstepClock = experiment.lockstepFIFO && experiment.clockMode == CLOCK_HAND;
+    if (benchmark.lengthCount > 0) {                                                    // benchmark mode, time the engines instead
+        for (int length = 0; length < benchmark.lengthCount; length++) {
+            if (benchmark.lengths[length] < 1 || benchmark.lengths[length] > INT_MAX) {
+                fprintf(stderr, "%s: benchmark trace lengths must be between 1 and %d\n", argv[0], INT_MAX);
+                return 1;
+            }
+        }
+        if (benchmark.repetitions < 1 || benchmark.warmups < 0) {
+            fprintf(stderr, "%s: benchmark repetitions must be >= 1 and warmups >= 0\n", argv[0]);
+            return 1;
+        }
+        int status = runBenchmark(&experiment, &benchmark);
+#ifdef INSTRUMENT
+        fprintf(stderr, "{\"main\": ");
+        dumpCounters(stderr, &mainCounters);
+        fprintf(stderr, "}\n");
+        freePageTable(&mainCounters.seen);
+#endif
+        return status == 0 ? 0 : 1;
+    }
+    TraceSource replay;                                                                 // trace file shared by the workers, if one is replayed
+    if (replayPath != NULL) {
+        if (openTraceFile(&replay, replayPath) != 0) { return 1; }
+        experiment.replay = &replay;
+    }
+    if (replayPath != NULL && experiment.sampleBudget == 0 && experiment.replayOPT) {   // approximate LRU runs no other policy
+        experiment.nextReferences = malloc((replay.length > 0 ? replay.length : 1) * sizeof(long long));
+        if (experiment.nextReferences == NULL) {
+            fprintf(stderr, "%s: out of memory\n", argv[0]);
+            return 1;
+        }
+        PHASE_BEGIN(PHASE_NEXT_REFERENCES);
+        findNextReferences(&replay, replay.length, experiment.nextReferences);          // one pass shared by every OPT unit
+        PHASE_END(PHASE_NEXT_REFERENCES);
+    }
 
-        for (int pageNumber = 0; pageNumber < 1000; pageNumber++) {                     // create 1000 normally distributed random numbers for the data set
-            double randomNumber = normal(10,2);                                         // generate the number
-            data[pageNumber] = (10 * ((int) (pageNumber / 100))) + randomNumber;        // number is scaled depending on the field it is located within
+    Worker *workers = calloc(threads, sizeof(Worker));                                  // per-thread state
+    pthread_t *handles = malloc(threads * sizeof(pthread_t));
+    if (workers == NULL || handles == NULL) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+    for (int thread = 0; thread < threads; thread++) {                                  // start every worker on the shared trace counter
+        workers[thread].experiment = &experiment;
+        workers[thread].FIFOResults = calloc(sizes, sizeof(long long));                 // resultant arrays start at 0
+        workers[thread].ClockResults = calloc(sizes, sizeof(long long));
+        workers[thread].OPTResults = calloc(sizes, sizeof(long long));
+        workers[thread].LRUEstimates = calloc(sizes, sizeof(long long));
+        if (workers[thread].FIFOResults == NULL || workers[thread].ClockResults == NULL || workers[thread].OPTResults == NULL
+                || workers[thread].LRUEstimates == NULL
+                || createHistogram(&workers[thread].LRUHistogram, experiment.maxWss) != 0) {
+            fprintf(stderr, "%s: out of memory\n", argv[0]);
+            return 1;
         }
+        void *(*body)(void *) = experiment.replay != NULL ? replayWorker : runWorker;
+        if (pthread_create(&handles[thread], NULL, body, &workers[thread]) != 0) {
+            fprintf(stderr, "%s: unable to start worker thread\n", argv[0]);
+            return 1;
+        }
+    }
 
-        for (int wss = 4; wss < 21; wss++) {                                            // iterate over all working set sizes from 4-20 (inclusive)
-            LRUResults[wss-4] += LRU(wss, data);                                        // Add results of LRU replacement to the resultant array
-            FIFOResults[wss-4]+= FIFO(wss, data);                                       // Add results of FIFO replacement to the resultant array
-            ClockResults[wss-4] += Clock(wss, data);                                    // Add results of Clock replacement to the resultant array
+    StackHistogram LRUHistogram;                                                        // histogram which will store LRU stack distances of all traces
+    long long *FIFOResults = calloc(sizes, sizeof(long long));                          // result set which will store FIFO results for each working set
+    long long *ClockResults = calloc(sizes, sizeof(long long));                         // result set which will store Clock results for each working set
+    long long *OPTResults = calloc(sizes, sizeof(long long));                           // result set which will store OPT results for each working set
+    long long *LRUEstimates = calloc(sizes, sizeof(long long));                         // result set which will store approximate LRU results
+    if (FIFOResults == NULL || ClockResults == NULL || OPTResults == NULL || LRUEstimates == NULL || createHistogram(&LRUHistogram, experiment.maxWss) != 0) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+#ifdef INSTRUMENT
+    Counters total = mainCounters;                                                      // counters of every thread together
+    fprintf(stderr, "{\"main\": ");
+    dumpCounters(stderr, &mainCounters);
+    fprintf(stderr, ",\n \"workers\": [");
+#endif
+    for (int thread = 0; thread < threads; thread++) {                                  // wait for each worker and reduce its results into the totals
+        pthread_join(handles[thread], NULL);
+#ifdef INSTRUMENT
+        fprintf(stderr, "%s\n  ", thread > 0 ? "," : "");
+        dumpCounters(stderr, &workers[thread].counters);
+        addCounters(&total, &workers[thread].counters);
+#endif
+        for (int distance = 1; distance <= experiment.maxWss + 1; distance++) {
+            LRUHistogram.reuse[distance] += workers[thread].LRUHistogram.reuse[distance];
+            LRUHistogram.first[distance] += workers[thread].LRUHistogram.first[distance];
+        }
+        for (int wss = experiment.minWss; wss <= experiment.maxWss; wss++) {
+            FIFOResults[wss-experiment.minWss] += workers[thread].FIFOResults[wss-experiment.minWss];
+            ClockResults[wss-experiment.minWss] += workers[thread].ClockResults[wss-experiment.minWss];
+            OPTResults[wss-experiment.minWss] += workers[thread].OPTResults[wss-experiment.minWss];
+            LRUEstimates[wss-experiment.minWss] += workers[thread].LRUEstimates[wss-experiment.minWss];
         }
+        freeHistogram(&workers[thread].LRUHistogram);
+        free(workers[thread].FIFOResults);
+        free(workers[thread].ClockResults);
+        free(workers[thread].OPTResults);
+        free(workers[thread].LRUEstimates);
     }
+#ifdef INSTRUMENT
+    fprintf(stderr, "],\n \"total\": ");
+    dumpCounters(stderr, &total);
+    fprintf(stderr, "}\n");
+#endif
 
-    for (int wss = 4; wss < 21; wss++) {                                                // iterate over each working set size
-        printf("Working Set %d - LRU - %d\n", wss, LRUResults[wss-4]);                  // print the number of page faults for LRU replacement for the set size
-        printf("Working Set %d - FIFO - %d\n", wss, FIFOResults[wss-4]);                // print the number of page faults for FIFO replacement for the set size
-        printf("Working Set %d - Clock - %d\n", wss, ClockResults[wss-4]);              // print the number of page faults for Clock replacement for the set size
+    long long references = experiment.replay != NULL ? experiment.replay->length : (long long) experiment.traces * TRACE_LENGTH;
+    double largestError = 0;                                                            // largest miss ratio error of approximate LRU
+    double totalError = 0;                                                              // sum of the absolute miss ratio errors
+    for (int wss = experiment.minWss; wss <= experiment.maxWss && experiment.sampleBudget > 0; wss++) {
+        long long estimate = (LRUEstimates[wss-experiment.minWss] + ESTIMATE_SCALE / 2) / ESTIMATE_SCALE;   // nearest whole fault
+        printf("Working Set %d - LRU (approximate) - %lld\n", wss, estimate);         // print the estimated number of page faults for LRU replacement
+        if (experiment.checkSamples) {                                                  // compare with the exact faults as miss ratios of all references
+            long long exact = getHistogramFaults(&LRUHistogram, wss);
+            double error = references > 0 ? (double) (estimate - exact) / references : 0;
+            printf("Working Set %d - LRU - %lld (miss ratio error %+.6f)\n", wss, exact, error);
+            if (fabs(error) > largestError) { largestError = fabs(error); }
+            totalError += fabs(error);
+        }
+        printf("\n");
+    }
+    if (experiment.checkSamples) {
+        printf("Miss ratio error - mean %.6f, largest %.6f\n", totalError / sizes, largestError);
+    }
+    for (int wss = experiment.minWss; wss <= experiment.maxWss && experiment.sampleBudget == 0; wss++) {   // iterate over each working set size
+        printf("Working Set %d - LRU - %lld\n", wss, getHistogramFaults(&LRUHistogram, wss));     // print the number of page faults for LRU replacement for the set size
+        printf("Working Set %d - FIFO - %lld\n", wss, FIFOResults[wss-experiment.minWss]);        // print the number of page faults for FIFO replacement for the set size
+        printf("Working Set %d - Clock - %lld\n", wss, ClockResults[wss-experiment.minWss]);      // print the number of page faults for Clock replacement for the set size
+        if (experiment.replay == NULL || experiment.replayOPT) {                        // print the optimal number of page faults for the set size
+            printf("Working Set %d - OPT - %lld\n", wss, OPTResults[wss-experiment.minWss]);
+        }
         printf("\n");
     }
+    if (experiment.replay != NULL) { closeTrace(experiment.replay); }
+    freeHistogram(&LRUHistogram);
+    free(FIFOResults);
+    free(ClockResults);
+    free(OPTResults);
+    free(LRUEstimates);
+    free(experiment.nextReferences);
+    free(workers);
+    free(handles);
+#ifdef INSTRUMENT
+    freePageTable(&mainCounters.seen);
+#endif
+    return 0;
 }
 
 /********************************************************************************************************************************************************
-* int LRU (int size, int data [])
+* void *runWorker (void *argument)
 * Author: Anton Horvath
-* Date: 30 October 2021
-* Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes a least-recently-used
-                strategy to determine which index is replaced. Keeps a counter variable that indicates how recently-accessed a value is
+* Date: 16 October 2026
+* Description:  body of a worker thread. Repeatedly claims the next TRACE_CHUNK traces from the shared counter until all experiments are taken.
+                Each trace's 1000 page numbers are generated in one batch from the seed and the trace number. LRU needs a single
+                pass over the trace since its stack distances give the page faults of every working set size. FIFO and Clock either make one
+                lockstep pass for all working set sizes or loop between them, adding their page faults to the worker's resultant arrays. The
+                next reference array OPT needs is built once per trace and shared by every working set size. In approximate mode a trace only
+                gets a SHARDS pass whose estimates are added to the worker's LRU estimates, plus the exact stack distance pass when the error
+                is measured
 * Parameters:
-*    size - int - size of the working set
-*    data - int [] - data set we are performing analysis on
-********************************************************************************************************************************************************/
-
-int LRU(int size, int data []) {
-    int counter = 0;                                                                    // counter is kept to track the age of values in the set
-    int faults = 0;                                                                     // the number of faults is tracked throughout the program
-    int set[size];                                                                      // the state of the working set
-    int counters[size];                                                                 // the state of the counter set (parallel array to working set)
-    for (int i = 0; i < 1000; i++) {                                                    // iterate over each value in the data set and attempt to fit page into ws
-        int index = 0;                                                                  // start with index of 0 for which value is getting replaced
-        int value = hasValue(data[i], set, size);                                       // determine if the value is already in the working set
-        if (counter < size) { index = counter; }                                        // if still not full, just set the index to be replaced as the the iterator
-        else if (value != -1) { index = value; }                                        // if found in set, set index to that point
-        else { index = getMinimumIndex(counters, size); faults++; }                     // if not found, page fault, get the smallest count value and replace at that index
-        
-        set[index] = data[i];                                                           // replace value at calculated index with the data value
-        counters[index] = counter;                                                      // set the counter value at the index to the largest as of that moment (most recent)
-        counter++;                                                                      // increment count
+*    argument - void* - the Worker this thread fills in
+********************************************************************************************************************************************************/
+
+void *runWorker(void *argument) {
+    Worker *worker = argument;
+    Experiment *experiment = worker->experiment;
+#ifdef INSTRUMENT
+    counters = &worker->counters;                                                       // everything this thread runs counts into the worker
+#endif
+    int data[TRACE_LENGTH];                                                             // data set which will store all page numbers for the experiment
+    long long nextReferences[TRACE_LENGTH];                                             // time of the next reference to each page number of the data set
+    TraceSource source;                                                                 // trace source reading the data set
+    openMemoryTrace(&source, data, TRACE_LENGTH);
+    Lockstep lockstep = { 0 };                                                          // state of every working set size for the lockstep engines,
+                                                                                        // only allocated when they run
+    SampledHistogram sampled;                                                           // scaled stack distances of the latest SHARDS pass
+    if ((experiment->lockstepFIFO && createLockstep(&lockstep, experiment->minWss, experiment->maxWss) != 0)
+            || createSampledHistogram(&sampled, experiment->maxWss) != 0) {
+        fprintf(stderr, "runWorker: out of memory\n");
+        exit(1);
     }
-    return faults;                                                                      // return the number of page faults calculated
+    for (;;) {
+        long long first = atomic_fetch_add(&experiment->nextTrace, TRACE_CHUNK);        // claim the next chunk of traces
+        if (first >= experiment->traces) { break; }                                     // every experiment has been claimed, worker is done
+        long long last = first + TRACE_CHUNK < experiment->traces ? first + TRACE_CHUNK : experiment->traces;
+        for (long long trace = first; trace < last; trace++) {
+            PHASE_BEGIN(PHASE_GENERATE);
+            generateTrace(data, TRACE_LENGTH, &experiment->locality, experiment->seed, trace);   // create 1000 normally distributed page numbers,
+            PHASE_END(PHASE_GENERATE);                                                  // they only depend on the seed and trace number
+
+            if (experiment->sampleBudget > 0) {                                         // approximate LRU, nothing else runs
+                rewindTrace(&source);
+                PHASE_BEGIN(PHASE_SAMPLE);
+                sampleDistances(&source, TRACE_LENGTH, experiment->sampleBudget, &sampled);
+                for (int wss = experiment->minWss; wss <= experiment->maxWss; wss++) {
+                    worker->LRUEstimates[wss-experiment->minWss] += llround(getSampledFaults(&sampled, wss) * ESTIMATE_SCALE);
+                }
+                PHASE_END(PHASE_SAMPLE);
+                if (experiment->checkSamples) {
+                    rewindTrace(&source);
+                    stackDistances(&source, TRACE_LENGTH, &worker->LRUHistogram);
+                }
+                continue;
+            }
+            rewindTrace(&source);
+            PHASE_BEGIN(PHASE_STACK);
+            stackDistances(&source, TRACE_LENGTH, &worker->LRUHistogram);               // LRU results of every working set size in one pass
+            PHASE_END(PHASE_STACK);
+            PHASE_BEGIN(PHASE_FIFO);
+            if (experiment->lockstepFIFO) {                                             // FIFO results of every working set size in one pass
+                rewindTrace(&source);
+                lockstepFIFO(&lockstep, &source, TRACE_LENGTH, worker->FIFOResults);
+            }
+            for (int wss = experiment->minWss; wss <= experiment->maxWss && !experiment->lockstepFIFO; wss++) {
+                rewindTrace(&source);                                                   // Add results of FIFO replacement to the resultant array
+                worker->FIFOResults[wss-experiment->minWss] += FIFO(wss, &source, TRACE_LENGTH);
+            }
+            PHASE_END(PHASE_FIFO);
+            PHASE_BEGIN(PHASE_CLOCK);
+            if (experiment->lockstepClock) {                                            // Clock results of every working set size in one pass
+                rewindTrace(&source);
+                lockstepClock(&lockstep, &source, TRACE_LENGTH, worker->ClockResults);
+            }
+            for (int wss = experiment->minWss; wss <= experiment->maxWss && !experiment->lockstepClock; wss++) {
+                rewindTrace(&source);                                                   // Add results of Clock replacement to the resultant array
+                worker->ClockResults[wss-experiment->minWss] += Clock(wss, &source, TRACE_LENGTH, experiment->clockMode);
+            }
+            PHASE_END(PHASE_CLOCK);
+            rewindTrace(&source);
+            PHASE_BEGIN(PHASE_NEXT_REFERENCES);
+            findNextReferences(&source, TRACE_LENGTH, nextReferences);                  // OPT's view of the future, shared by every working set size
+            PHASE_END(PHASE_NEXT_REFERENCES);
+            PHASE_BEGIN(PHASE_OPT);
+            for (int wss = experiment->minWss; wss <= experiment->maxWss; wss++) {      // iterate over all working set sizes (4-20 inclusive by default)
+                rewindTrace(&source);                                                   // Add results of OPT replacement to the resultant array
+                worker->OPTResults[wss-experiment->minWss] += OPT(wss, &source, TRACE_LENGTH, nextReferences);
+            }
+            PHASE_END(PHASE_OPT);
+        }
+    }
+    freeLockstep(&lockstep);
+    freeSampledHistogram(&sampled);
+#ifdef INSTRUMENT
+    freePageTable(&counters->seen);                                                     // table of the thread's last pass
+#endif
+    return NULL;
 }
 
 /********************************************************************************************************************************************************
-* int hasValue (int value, int set [], int size)
+* void *replayWorker (void *argument)
 * Author: Anton Horvath
-* Date: 30 October 2021
-* Description:  returns the index of a value in a set, -1 if not found
+* Date: 16 October 2026
+* Description:  body of a worker thread when a trace file is replayed. Work unit 0 is the single stack distance pass that gives LRU its page
+                faults for every working set size. The FIFO units follow, a single lockstep pass or one unit per working set size, then the
+                Clock units in the same way and finally, with -o, one OPT unit per working set size. In approximate mode unit 0 is the SHARDS
+                pass and unit 1, only when the error is measured, the exact stack distance pass. Units are claimed from the shared counter
+                until none are left, each one streaming the trace file from its first page number through the worker's own cursor on the
+                shared mapping
 * Parameters:
-*    size - int - size of the working set
-*    value - int - the value we're querying for in the set
-*    set - int [] - set we are searching in
+*    argument - void* - the Worker this thread fills in
+********************************************************************************************************************************************************/
+
+void *replayWorker(void *argument) {
+    Worker *worker = argument;
+    Experiment *experiment = worker->experiment;
+#ifdef INSTRUMENT
+    counters = &worker->counters;                                                       // everything this thread runs counts into the worker
+#endif
+    TraceSource cursor = *experiment->replay;                                           // copy shares the mapping but reads on its own
+    int sizes = experiment->maxWss - experiment->minWss + 1;
+    int FIFOUnits = experiment->lockstepFIFO ? 1 : sizes;                               // units after the LRU pass that run FIFO
+    int ClockUnits = experiment->lockstepClock ? 1 : sizes;                             // units after the FIFO ones that run Clock
+    int OPTUnits = experiment->nextReferences != NULL ? sizes : 0;                      // units after the Clock ones that run OPT
+    int units = experiment->sampleBudget > 0 ? 1 + experiment->checkSamples : 1 + FIFOUnits + ClockUnits + OPTUnits;
+    Lockstep lockstep = { 0 };                                                          // state of every working set size for the lockstep engines,
+                                                                                        // only allocated when they run
+    SampledHistogram sampled;                                                           // scaled stack distances of the SHARDS pass
+    if ((experiment->lockstepFIFO && createLockstep(&lockstep, experiment->minWss, experiment->maxWss) != 0)
+            || createSampledHistogram(&sampled, experiment->maxWss) != 0) {
+        fprintf(stderr, "replayWorker: out of memory\n");
+        exit(1);
+    }
+    for (;;) {
+        long long claimed = atomic_fetch_add(&experiment->nextTrace, 1);                // claim the next unit
+        if (claimed >= units) { break; }                                                // every unit has been claimed, worker is done
+        int unit = (int) claimed;
+        rewindTrace(&cursor);
+        if (unit == 0 && experiment->sampleBudget > 0) {
+            PHASE_BEGIN(PHASE_SAMPLE);
+            sampleDistances(&cursor, cursor.length, experiment->sampleBudget, &sampled);
+            for (int wss = experiment->minWss; wss <= experiment->maxWss; wss++) {
+                worker->LRUEstimates[wss-experiment->minWss] += llround(getSampledFaults(&sampled, wss) * ESTIMATE_SCALE);
+            }
+            PHASE_END(PHASE_SAMPLE);
+        }
+        else if (unit <= 1 && (unit == 0 || experiment->sampleBudget > 0)) {             // exact LRU, unit 1 in approximate mode
+            PHASE_BEGIN(PHASE_STACK);
+            stackDistances(&cursor, cursor.length, &worker->LRUHistogram);
+            PHASE_END(PHASE_STACK);
+        }
+        else if (unit <= FIFOUnits) {
+            PHASE_BEGIN(PHASE_FIFO);
+            if (experiment->lockstepFIFO) { lockstepFIFO(&lockstep, &cursor, cursor.length, worker->FIFOResults); }
+            else { worker->FIFOResults[unit-1] += FIFO(experiment->minWss + unit - 1, &cursor, cursor.length); }
+            PHASE_END(PHASE_FIFO);
+        }
+        else if (unit <= FIFOUnits + ClockUnits) {
+            int index = unit - 1 - FIFOUnits;                                           // working set size index of a per-size Clock unit
+            PHASE_BEGIN(PHASE_CLOCK);
+            if (experiment->lockstepClock) { lockstepClock(&lockstep, &cursor, cursor.length, worker->ClockResults); }
+            else { worker->ClockResults[index] += Clock(experiment->minWss + index, &cursor, cursor.length, experiment->clockMode); }
+            PHASE_END(PHASE_CLOCK);
+        }
+        else {
+            int index = unit - 1 - FIFOUnits - ClockUnits;                              // working set size index of an OPT unit
+            PHASE_BEGIN(PHASE_OPT);
+            worker->OPTResults[index] += OPT(experiment->minWss + index, &cursor, cursor.length, experiment->nextReferences);
+            PHASE_END(PHASE_OPT);
+        }
+    }
+    freeLockstep(&lockstep);
+    freeSampledHistogram(&sampled);
+#ifdef INSTRUMENT
+    freePageTable(&counters->seen);                                                     // table of the thread's last pass
+#endif
+    return NULL;
+}
+
+/********************************************************************************************************************************************************
+* int runBenchmark (Experiment *experiment, Benchmark *benchmark)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  times the trace generator and every replacement engine on the calling thread, pinned to the processor it runs on so the timings
+                are not disturbed by migrations. For each requested length one trace is generated from the experiment's seed and locality
+                model, then every target runs the benchmark's warmups untimed followed by its timed repetitions. The all-sizes targets (stack
+                distances, lockstep FIFO and Clock when the working set sizes allow them, the next reference pass) run once per repetition,
+                LRU, FIFO, Clock and OPT once per working set size. The statistics of each target are output through reportTarget. Returns 0,
+                or -1 if memory could not be allocated
+* Parameters:
+*    experiment - Experiment* - seed, locality model, working set sizes and Clock mode the engines run with
+*    benchmark - Benchmark* - trace lengths, repetitions, warmups and output format
 ********************************************************************************************************************************************************/
 
-int hasValue (int value, int set [], int size) {
-    for (int i = 0; i < size; i++) {                                                    // iterate through each value in the set
-        if (set[i] == value) { return i; }                                              // return index it was found
+int runBenchmark(Experiment *experiment, Benchmark *benchmark) {
+    long long longest = 0;                                                              // largest trace length, sizes the buffers
+    for (int length = 0; length < benchmark->lengthCount; length++) {
+        if (benchmark->lengths[length] > longest) { longest = benchmark->lengths[length]; }
+    }
+    int sizes = experiment->maxWss - experiment->minWss + 1;
+    double *samples = malloc(benchmark->repetitions * sizeof(double));                  // nanoseconds per reference of every timed repetition
+    benchmark->data = malloc(longest * sizeof(int));
+    benchmark->nextReferences = malloc(longest * sizeof(long long));
+    benchmark->faults = calloc(sizes, sizeof(long long));
+    if (samples == NULL || benchmark->data == NULL || benchmark->nextReferences == NULL || benchmark->faults == NULL
+            || createHistogram(&benchmark->histogram, experiment->maxWss) != 0
+            || (experiment->lockstepFIFO && createLockstep(&benchmark->lockstep, experiment->minWss, experiment->maxWss) != 0)) {
+        fprintf(stderr, "runBenchmark: out of memory\n");
+        return -1;
+    }
+    pinThread();
+    if (benchmark->format == BENCHMARK_CSV) {
+        printf("target,length,wss,repetitions,warmups,refs_per_second,ns_per_reference,variance,min_ns_per_reference,faults\n");
+    }
+    else { printf("["); }
+    char range[32];                                                                     // working set sizes of the all-sizes targets
+    snprintf(range, sizeof(range), "%d-%d", experiment->minWss, experiment->maxWss);
+    for (int length = 0; length < benchmark->lengthCount; length++) {
+        benchmark->length = benchmark->lengths[length];
+        generateTrace(benchmark->data, (int) benchmark->length, &experiment->locality, experiment->seed, 0);
+        openMemoryTrace(&benchmark->source, benchmark->data, benchmark->length);
+        findNextReferences(&benchmark->source, benchmark->length, benchmark->nextReferences);
+        for (int target = 0; target < TARGETS; target++) {
+            if ((target == TARGET_LOCKSTEP_FIFO && !experiment->lockstepFIFO)           // lockstep engines only run for small working sets
+                    || (target == TARGET_LOCKSTEP_CLOCK && !experiment->lockstepClock)) { continue; }
+            int first = target < TARGET_LRU ? experiment->maxWss : experiment->minWss;  // all-sizes targets run once
+            for (int size = first; size <= experiment->maxWss; size++) {
+                long long faults = 0;                                                   // page faults of the latest run
+                for (int run = 0; run < benchmark->warmups; run++) { timeTarget(experiment, benchmark, target, size, &faults); }
+                for (int run = 0; run < benchmark->repetitions; run++) {
+                    samples[run] = timeTarget(experiment, benchmark, target, size, &faults) / benchmark->length;
+                }
+                char wss[16];
+                snprintf(wss, sizeof(wss), "%d", size);
+                reportTarget(benchmark, target, target < TARGET_LRU ? range : wss, samples, faults);
+            }
+        }
+    }
+    if (benchmark->format == BENCHMARK_JSON) { printf("\n]\n"); }
+    free(samples);
+    free(benchmark->data);
+    free(benchmark->nextReferences);
+    free(benchmark->faults);
+    freeHistogram(&benchmark->histogram);
+    freeLockstep(&benchmark->lockstep);
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* double timeTarget (Experiment *experiment, Benchmark *benchmark, int target, int size, long long *faults)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  runs a benchmark target once over the benchmark's trace and returns the nanoseconds it took on the monotonic clock. Only the
+                call to the engine is timed, rewinding the trace and clearing the previous results happen before the clock starts. The page
+                faults found are stored in faults, summed over every working set size for the all-sizes targets and 0 for the targets that
+                do not simulate a working set, so a change in behaviour between builds shows up next to a change in speed
+* Parameters:
+*    experiment - Experiment* - locality model, seed, working set sizes and Clock mode
+*    benchmark - Benchmark* - trace and engine state
+*    target - int - one of the TARGET_ values
+*    size - int - working set size of the per-size targets
+*    faults - long long* - page faults of the run
+********************************************************************************************************************************************************/
+
+double timeTarget(Experiment *experiment, Benchmark *benchmark, int target, int size, long long *faults) {
+    int sizes = experiment->maxWss - experiment->minWss + 1;
+    rewindTrace(&benchmark->source);
+    memset(benchmark->faults, 0, sizes * sizeof(long long));
+    memset(benchmark->histogram.reuse, 0, (experiment->maxWss + 2) * sizeof(long long));
+    memset(benchmark->histogram.first, 0, (experiment->maxWss + 2) * sizeof(long long));
+    *faults = 0;
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (target == TARGET_GENERATE) {
+        generateTrace(benchmark->data, (int) benchmark->length, &experiment->locality, experiment->seed, 0);
+    }
+    else if (target == TARGET_STACK) { stackDistances(&benchmark->source, benchmark->length, &benchmark->histogram); }
+    else if (target == TARGET_LOCKSTEP_FIFO) { lockstepFIFO(&benchmark->lockstep, &benchmark->source, benchmark->length, benchmark->faults); }
+    else if (target == TARGET_LOCKSTEP_CLOCK) { lockstepClock(&benchmark->lockstep, &benchmark->source, benchmark->length, benchmark->faults); }
+    else if (target == TARGET_NEXT_REFERENCES) { findNextReferences(&benchmark->source, benchmark->length, benchmark->nextReferences); }
+    else if (target == TARGET_LRU) { *faults = LRU(size, &benchmark->source, benchmark->length); }
+    else if (target == TARGET_FIFO) { *faults = FIFO(size, &benchmark->source, benchmark->length); }
+    else if (target == TARGET_CLOCK) { *faults = Clock(size, &benchmark->source, benchmark->length, experiment->clockMode); }
+    else if (target == TARGET_OPT) { *faults = OPT(size, &benchmark->source, benchmark->length, benchmark->nextReferences); }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    for (int wss = experiment->minWss; wss <= experiment->maxWss; wss++) {              // totals of the all-sizes targets
+        if (target == TARGET_STACK) { *faults += getHistogramFaults(&benchmark->histogram, wss); }
+        else if (target == TARGET_LOCKSTEP_FIFO || target == TARGET_LOCKSTEP_CLOCK) { *faults += benchmark->faults[wss-experiment->minWss]; }
+    }
+    return (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+}
+
+/********************************************************************************************************************************************************
+* void reportTarget (Benchmark *benchmark, int target, const char *sizes, double *samples, long long faults)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  outputs the mean references per second, the mean, sample variance and minimum of the nanoseconds per reference over the timed
+                repetitions and the page faults of a benchmark target, as a CSV row or as the next object of the JSON array
+* Parameters:
+*    benchmark - Benchmark* - trace length, repetitions, warmups and output format
+*    target - int - one of the TARGET_ values
+*    sizes - const char* - working set size, or range of sizes, the target ran with
+*    samples - double* - nanoseconds per reference of every timed repetition
+*    faults - long long - page faults of the last repetition
+********************************************************************************************************************************************************/
+
+void reportTarget(Benchmark *benchmark, int target, const char *sizes, double *samples, long long faults) {
+    double mean = 0;                                                                    // mean nanoseconds per reference
+    double minimum = samples[0];                                                        // fastest repetition
+    for (int run = 0; run < benchmark->repetitions; run++) {
+        mean += samples[run] / benchmark->repetitions;
+        if (samples[run] < minimum) { minimum = samples[run]; }
+    }
+    double variance = 0;                                                                // sample variance, 0 for a single repetition
+    for (int run = 0; run < benchmark->repetitions && benchmark->repetitions > 1; run++) {
+        variance += (samples[run] - mean) * (samples[run] - mean) / (benchmark->repetitions - 1);
+    }
+    double rate = mean > 0 ? 1e9 / mean : 0;                                            // references per second
+    if (benchmark->format == BENCHMARK_CSV) {
+        printf("%s,%lld,%s,%d,%d,%.0f,%.3f,%.6f,%.3f,%lld\n", targetNames[target], benchmark->length, sizes, benchmark->repetitions,
+               benchmark->warmups, rate, mean, variance, minimum, faults);
+    }
+    else {
+        printf("%s\n  {\"target\": \"%s\", \"length\": %lld, \"wss\": \"%s\", \"repetitions\": %d, \"warmups\": %d, "
+               "\"refs_per_second\": %.0f, \"ns_per_reference\": %.3f, \"variance\": %.6f, \"min_ns_per_reference\": %.3f, "
+               "\"faults\": %lld}", benchmark->reported > 0 ? "," : "", targetNames[target], benchmark->length, sizes,
+               benchmark->repetitions, benchmark->warmups, rate, mean, variance, minimum, faults);
+    }
+    benchmark->reported++;
+}
+
+/********************************************************************************************************************************************************
+* void pinThread (void)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  pins the calling thread to the processor it is currently running on, so every repetition runs with the same caches. A warning is
+                output and the benchmark carries on unpinned if the processor or the affinity cannot be set
+* Parameters:
+*    none
+********************************************************************************************************************************************************/
+
+void pinThread(void) {
+    int processor = sched_getcpu();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (processor >= 0) { CPU_SET(processor, &set); }
+    if (processor < 0 || sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "pinThread: unable to pin the benchmark thread, timings may vary\n");
     }
-    return -1;                                                                          // return -1 for couldn't find
 }
 
 /********************************************************************************************************************************************************
-* int getMinimumIndex (int counters [], int size)
+* long long LRU (int size, TraceSource *trace, long long length)
 * Author: Anton Horvath
 * Date: 30 October 2021
-* Description:  returns the smallest number in a given set, used to find which count value is the smallest (representing oldest page number)
+* Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes a least-recently-used
+                strategy to determine which index is replaced. A hash table maps every resident page to its frame and the frames are kept in a
+                doubly linked list ordered by recency, so finding a page and the least recently used victim take constant time whatever the
+                size. Pages missing while the working set still has free frames fill the next free frame and are not counted as page faults
 * Parameters:
-*    counters - int [] - counter set we are checking for smallest value
-*    size - int - size of the set
+*    size - int - size of the working set
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
 ********************************************************************************************************************************************************/
 
-int getMinimumIndex (int counters [], int size) {
-    int minimum = counters[0];                                                          // sets default minimum to be the first index in the set
-    int minimumIndex = 0;                                                               // capture index of minimum value
-    for (int i = 1; i < size; i++) {                                                    // iterate through all values in the set
-        if (counters[i] < minimum) {                                                    // detect if the value is less than the current minimum value
-            minimum = counters[i];                                                      // set minimum value to be the value we iterated over
-            minimumIndex = i;                                                           // set the index to be the minimum value's index
+long long LRU(int size, TraceSource *trace, long long length) {
+    long long faults = 0;                                                               // the number of faults is tracked throughout the program
+    int filled = 0;                                                                     // number of frames of the working set holding a page
+    int *set = malloc(size * sizeof(int));                                              // the state of the working set
+    RecencyList recency;                                                                // frames ordered from least to most recently used
+    PageTable frames;                                                                   // frame holding each resident page
+    if (set == NULL || createRecencyList(&recency, size) != 0 || createPageTable(&frames, size) != 0) {
+        fprintf(stderr, "LRU: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    COUNT_PASS();
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {                                               // iterate over each value in the block and attempt to fit page into ws
+            COUNT_REFERENCE(data[i]);
+            int index = 0;                                                              // start with index of 0 for which value is getting replaced
+            int *frame = findPage(&frames, data[i]);                                    // determine if the value is already in the working set
+            if (frame != NULL) {                                                        // if found in set, set index to that point
+                COUNT_HITS(POLICY_LRU, 1);
+                index = *frame;
+                unlinkFrame(&recency, index);
+            }
+            else if (filled < size) {                                                   // if still not full, the next free frame receives the page
+                COUNT_MISS(POLICY_LRU);
+                index = filled++;
+                insertPage(&frames, data[i], index);
+            }
+            else {                                                                      // if not found, page fault, replace the least recently used frame
+                COUNT_MISS(POLICY_LRU);
+                COUNT_FAULT(POLICY_LRU);
+                index = recency.oldest;
+                unlinkFrame(&recency, index);
+                removePage(&frames, set[index]);
+                insertPage(&frames, data[i], index);
+                faults++;
+            }
+            set[index] = data[i];                                                       // replace value at calculated index with the data value
+            appendFrame(&recency, index);                                               // the frame is now the most recently used
         }
     }
-    return minimumIndex;                                                                // return the minimum value's index
+    free(set);
+    freeRecencyList(&recency);
+    freePageTable(&frames);
+    return faults;                                                                      // return the number of page faults calculated
 }
 
 /********************************************************************************************************************************************************
-* int FIFO (int counters [], int size)
+* long long FIFO (int size, TraceSource *trace, long long length)
 * Author: Anton Horvath
 * Date: 30 October 2021
 * Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes a first-in-first-out
-                strategy to determine which index is replaced. Uses index-based age determination for FIFO
+                strategy to determine which index is replaced. The working set is a circular buffer whose head is the oldest frame, so a fault
+                replaces the head and moves it one frame forward instead of shifting the whole set. A hash table of the resident pages finds a
+                page without scanning the working set. Pages missing while the working set still has free frames are attached to the end and
+                are not counted as page faults
 * Parameters:
-*    data - int* - data set for the given experiment
 *    size - int - size of the set
+*    trace - TraceSource* - trace source the data set for the given experiment is read from
+*    length - long long - number of page numbers read from the trace source
 ********************************************************************************************************************************************************/
 
-int FIFO(int size, int *data) {
-    int faults = 0;                                                                     // set the default number of faults to 0
-    int set[size];                                                                      // allocate space for the working set based on given size
-    for (int i = 0; i < 1000; i++) {                                                    // iterate over all page numbers in set, fitting them into the working set
-        if (i < size) { set[i] = data[i]; }                                             // if working set is still not full, set value at given index
-        else if (hasValue(data[i], set, size) == -1) {                                  // if the value is not present within the working set, shift all
-            replace(0, set, size, data[i]);                                             // values in working set over 1 to the left and attach value to end
-            faults++;                                                                   // increment number of faults found
+long long FIFO(int size, TraceSource *trace, long long length) {
+    long long faults = 0;                                                               // set the default number of faults to 0
+    int filled = 0;                                                                     // number of frames of the working set holding a page
+    int head = 0;                                                                       // frame holding the oldest page, replaced by the next fault
+    int *set = malloc(size * sizeof(int));                                              // allocate space for the working set based on given size
+    PageTable resident;                                                                 // pages currently in the working set
+    if (set == NULL || createPageTable(&resident, size) != 0) {
+        fprintf(stderr, "FIFO: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    COUNT_PASS();
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {                                               // iterate over all page numbers in block, fitting them into the working set
+            COUNT_REFERENCE(data[i]);
+            if (findPage(&resident, data[i]) != NULL) { COUNT_HITS(POLICY_FIFO, 1); continue; }   // page already in the working set, nothing to replace
+            COUNT_MISS(POLICY_FIFO);
+            if (filled < size) { set[filled++] = data[i]; }                             // if working set is still not full, attach value to the end
+            else {                                                                      // if the working set is full, the oldest page is replaced and
+                COUNT_FAULT(POLICY_FIFO);
+                removePage(&resident, set[head]);                                       // the next oldest becomes the head
+                set[head] = data[i];
+                head = head + 1 < size ? head + 1 : 0;
+                faults++;                                                               // increment number of faults found
+            }
+            insertPage(&resident, data[i], 0);                                          // page is now resident
         }
     }
+    free(set);
+    freePageTable(&resident);
     return faults;                                                                      // return sum of faults encountered during data processing
 }
 
 /********************************************************************************************************************************************************
-* int replace (int startingIndex, int set [], int size, int value)
+* long long Clock (int size, TraceSource *trace, long long length, int mode)
 * Author: Anton Horvath
 * Date: 30 October 2021
-* Description:  shifts all values of an array over by 1 to the left and attaches the given value to the end, used for index-based FIFO
+* Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes a clock
+                strategy to determine which index is replaced. A hash table maps every resident page to its frame, a reference sets the frame's
+                use-bit and a fault replaces the frame chosen by the mode. CLOCK_HAND keeps a hand over the frames between faults that clears
+                use-bits until it reaches a 0, CLOCK_OLDEST_FIRST restarts the sweep from the oldest page on every fault (the counts Clock gave
+                before 16 October 2026) by walking a list of the frames in arrival order. Pages missing while the working set still has free
+                frames fill the next free frame and are not counted as page faults
 * Parameters:
-*    startingIndex - int - index that is to be removed, with everything to the right shifting towards it
-*    set - int [] - current working set
 *    size - int - size of the set
-*    value - int - value getting attached to the end of the set once everything is shifted over one to the left
+*    trace - TraceSource* - trace source the data set for the given experiment is read from
+*    length - long long - number of page numbers read from the trace source
+*    mode - int - CLOCK_HAND or CLOCK_OLDEST_FIRST
+********************************************************************************************************************************************************/
+
+long long Clock(int size, TraceSource *trace, long long length, int mode) {
+    long long faults = 0;                                                               // set default number of faults to 0
+    int filled = 0;                                                                     // number of frames of the working set holding a page
+    int hand = 0;                                                                       // frame the clock hand points at
+    int *set = malloc(size * sizeof(int));                                              // the current working set is allocated space
+    int *useBits = malloc(size * sizeof(int));                                          // store the use bits in a parallel array alongside working set
+    RecencyList arrival;                                                                // frames ordered from oldest to newest page (CLOCK_OLDEST_FIRST)
+    PageTable frames;                                                                   // frame holding each resident page
+    if (set == NULL || useBits == NULL || createRecencyList(&arrival, size) != 0 || createPageTable(&frames, size) != 0) {
+        fprintf(stderr, "Clock: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    COUNT_PASS();
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {                                               // iterate over all page numbers in the block
+            COUNT_REFERENCE(data[i]);
+            int *frame = findPage(&frames, data[i]);                                    // capture if the value is already in the working set
+            if (frame != NULL) { COUNT_HITS(POLICY_CLOCK, 1); useBits[*frame] = 1; continue; }   // if the value was referenced, give second-life
+            COUNT_MISS(POLICY_CLOCK);
+            int index = 0;                                                              // set default index value to be 0
+            if (filled < size) { index = filled++; }                                    // if working set isn't full, the next free frame is used
+            else {                                                                      // not in the working set, have to find the first 0 use-bit
+                COUNT_FAULT(POLICY_CLOCK);
+                if (mode == CLOCK_HAND) { index = getClockIndex(size, useBits, &hand); }
+                else {
+                    index = getOldestClockIndex(&arrival, useBits);
+                    unlinkFrame(&arrival, index);
+                }
+                removePage(&frames, set[index]);
+                faults++;                                                               // increase number of page faults encountered
+            }
+            if (mode == CLOCK_OLDEST_FIRST) { appendFrame(&arrival, index); }           // page just added is the newest
+            set[index] = data[i];
+            useBits[index] = 0;                                                         // use-bit of a page just added is set to 0
+            insertPage(&frames, data[i], index);
+        }
+    }
+    free(set);
+    free(useBits);
+    freeRecencyList(&arrival);
+    freePageTable(&frames);
+    return faults;                                                                      // return number of faults encountered
+}
+
+/********************************************************************************************************************************************************
+* long long OPT (int size, TraceSource *trace, long long length, const long long *nextReferences)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes Belady's optimal
+                strategy, a fault replaces the page whose next reference lies furthest in the future, which no other algorithm can beat. The
+                frames are kept in a max-heap keyed on the next reference of their page, read from the precomputed next reference array, so
+                the victim is the root and every reference costs O(log size). A hash table maps every resident page to its frame. Pages missing
+                while the working set still has free frames fill the next free frame and are not counted as page faults
+* Parameters:
+*    size - int - size of the working set
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    nextReferences - const long long* - next reference time of every page number of the data set, from findNextReferences
 ********************************************************************************************************************************************************/
 
-void replace(int startingIndex, int set [], int size, int value) {
-    for (int i = startingIndex+1; i < size; i++) {                                      // iterate over all values to the right of the index being replaced
-        set[i-1] = set[i];                                                              // set the previous index to be the current index (offset by 1, shift)
+long long OPT(int size, TraceSource *trace, long long length, const long long *nextReferences) {
+    long long faults = 0;                                                               // set the default number of faults to 0
+    int filled = 0;                                                                     // number of frames of the working set holding a page
+    long long time = 0;                                                                 // reference time of the current page number
+    int *set = malloc(size * sizeof(int));                                              // the state of the working set
+    NextUseHeap upcoming;                                                               // frames ordered by the next reference to their page
+    PageTable frames;                                                                   // frame holding each resident page
+    if (set == NULL || createNextUseHeap(&upcoming, size) != 0 || createPageTable(&frames, size) != 0) {
+        fprintf(stderr, "OPT: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    COUNT_PASS();
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++, time++) {                                       // iterate over each page number in the block
+            COUNT_REFERENCE(data[i]);
+            int *frame = findPage(&frames, data[i]);                                    // determine if the value is already in the working set
+            if (frame != NULL) {                                                        // page stays, only its next use moves
+                COUNT_HITS(POLICY_OPT, 1);
+                updateFrame(&upcoming, *frame, nextReferences[time]);
+                continue;
+            }
+            COUNT_MISS(POLICY_OPT);
+            int index = 0;                                                              // frame receiving the page
+            if (filled < size) {                                                        // if still not full, the next free frame receives the page
+                index = filled++;
+                pushFrame(&upcoming, index, nextReferences[time]);
+            }
+            else {                                                                      // page fault, replace the page referenced furthest ahead
+                COUNT_FAULT(POLICY_OPT);
+                index = upcoming.heap[0];
+                removePage(&frames, set[index]);
+                updateFrame(&upcoming, index, nextReferences[time]);
+                faults++;
+            }
+            set[index] = data[i];
+            insertPage(&frames, data[i], index);
+        }
     }
-    set[size-1] = value;                                                                // attach given value to end of the set
+    free(set);
+    freeNextUseHeap(&upcoming);
+    freePageTable(&frames);
+    return faults;                                                                      // return the number of page faults calculated
 }
 
 /********************************************************************************************************************************************************
-* int Clock (int size, int *data)
+* int getClockIndex (int size, int *useBits, int *hand)
 * Author: Anton Horvath
 * Date: 30 October 2021
-* Description:  returns the number of page faults encountered during page number replacement of the given data set. Utilizes a clock
-                strategy to determine which index is replaced. Uses FIFO variant in retrieving first 0 use-bit. Uses index-based FIFO
+* Description:  moves the clock hand over the use-bits, decrementing the ones that are not 0, until it reaches a 0. Returns that index and leaves
+                the hand on the frame after it, so the next fault continues the sweep where this one stopped
 * Parameters:
-*    data - int* - data set for the given experiment
 *    size - int - size of the set
+*    useBits - int* - use-bit set given
+*    hand - int* - frame the clock hand points at
 ********************************************************************************************************************************************************/
 
-int Clock(int size, int *data) {
-    int faults = 0;                                                                     // set default number of faults to 0
-    int set[size];                                                                      // the current working set is allocated space
-    int useBits[size];                                                                  // store the use bits in a parallel array alongside working set
-    for (int i = 0; i < 1000; i++) {                                                    // iterate over all page numbers in the data set
-        int value = hasValue(data[i], set, size);                                       // capture if the value is already in the working set
-        int index = 0;                                                                  // set default index value to be 0
-        if (i < size) { index = i; }                                                    // if working set isn't full, the index to be replaced is simply
-        else if (value != -1) { index = value; }                                        // the iterator value, if contained in set already index is where it
-        else {                                                                          // is at
-            index = getClockIndex(size, useBits);                                       // not in the working set, have to find the FIFO first 0 use-bit
-            replace(index, set, size, data[i]);                                         // once the index of first 0 captured, shift working set and attach
-            replace(index, useBits, size, 0);                                           // value to end, do the same for use-bits
-            faults++;                                                                   // increase number of page faults encountered
-            index = size-1;                                                             // index is set to the end
-        }
-        set[index] = data[i];
-        useBits[index] = value == -1 ? 0 : 1;                                           // if the value was referenced, give second-life. Otherwise, set to 0
-    }                                                                                   // if just added
-    return faults;                                                                      // return number of faults encountered
+int getClockIndex(int size, int *useBits, int *hand) {
+    while (useBits[*hand] != 0) {                                                       // frame was referenced, take away its second-life
+        COUNT_SWEEP_STEP();
+        useBits[*hand] = useBits[*hand] - 1;
+        *hand = *hand + 1 < size ? *hand + 1 : 0;
+    }
+    COUNT_SWEEP_END();
+    int index = *hand;
+    *hand = *hand + 1 < size ? *hand + 1 : 0;                                           // the frame is replaced, hand moves past it
+    return index;
 }
 
 /********************************************************************************************************************************************************
-* int getClockIndex (int size, int *useBits)
+* int getOldestClockIndex (RecencyList *arrival, int *useBits)
 * Author: Anton Horvath
-* Date: 30 October 2021
-* Description:  iterate over the use-bits set and attempt to find the first 0. Since index-based FIFO is being used, we simply start at the beginning and
-                find the first 0, return the index
+* Date: 16 October 2026
+* Description:  iterate over the frames from the oldest page to the newest and attempt to find the first 0 use-bit, decrementing the ones that are
+                not 0. Starts over from the oldest page if every use-bit was set, return the index
 * Parameters:
+*    arrival - RecencyList* - frames ordered from oldest to newest page
 *    useBits - int* - use-bit set given
-*    size - int - size of the set
 ********************************************************************************************************************************************************/
 
-int getClockIndex(int size, int *useBits) {
-    int index = -1;
-    while (index < 0) {
-        for (int i = 0; i < size; i++) {
-            if (useBits[i] == 0) { return i; }
-            else { useBits[i] = useBits[i] - 1; }
+int getOldestClockIndex(RecencyList *arrival, int *useBits) {
+    for (int frame = arrival->oldest; ; frame = arrival->newer[frame]) {
+        if (frame == -1) { frame = arrival->oldest; }                                   // passed the newest page, start over from the oldest
+        if (useBits[frame] == 0) { COUNT_SWEEP_END(); return frame; }
+        else { COUNT_SWEEP_STEP(); useBits[frame] = useBits[frame] - 1; }
+    }
+}
+
+/********************************************************************************************************************************************************
+* void findNextReferences (TraceSource *trace, long long length, long long *nextReferences)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  stores in nextReferences[t] the time of the next reference to the page referenced at time t, NEVER if it is not referenced again.
+                The data set is read once from front to back: every page keeps the time it was last seen and each reference fills in that
+                time's entry, which gives the same array as a backward pass without the trace source having to be read in reverse. Pages are
+                numbered in order of first reference so the last seen times fit a plain array
+* Parameters:
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    nextReferences - long long* - array of length entries being filled in
+********************************************************************************************************************************************************/
+
+void findNextReferences(TraceSource *trace, long long length, long long *nextReferences) {
+    int distinct = 0;                                                                   // number of distinct pages referenced so far
+    int capacity = TRACE_BLOCK;                                                         // number of pages lastSeen can hold
+    long long time = 0;                                                                 // reference time of the current page number
+    long long *lastSeen = malloc(capacity * sizeof(long long));                         // lastSeen[p] - time of the latest reference to the p-th page
+    PageTable pages;                                                                    // number of every page, in order of first reference
+    if (lastSeen == NULL || createPageTable(&pages, capacity) != 0) {
+        fprintf(stderr, "findNextReferences: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++, time++) {                                       // iterate over each page number in the block
+            nextReferences[time] = NEVER;                                               // until the page shows up again
+            int *page = findPage(&pages, data[i]);
+            if (page != NULL) {                                                         // page seen before, its previous reference is answered
+                nextReferences[lastSeen[*page]] = time;
+                lastSeen[*page] = time;
+                continue;
+            }
+            if (distinct == capacity) {                                                 // every slot is used, double lastSeen
+                capacity *= 2;
+                lastSeen = realloc(lastSeen, capacity * sizeof(long long));
+                if (lastSeen == NULL) {
+                    fprintf(stderr, "findNextReferences: out of memory\n");
+                    exit(1);
+                }
+            }
+            lastSeen[distinct] = time;
+            insertPage(&pages, data[i], distinct++);
         }
     }
-    return index;
+    free(lastSeen);
+    freePageTable(&pages);
 }
 
 /********************************************************************************************************************************************************
-* double normal (double mu, double sigma)
-* Author: Phoxis
-* //https://phoxis.org/2013/05/04/generating-random-numbers-from-normal-distribution-in-c/
-* Modifier: Anton Horvath
-* Date: 30 October 2021
-* Description:  obtain a normally distributed random number with a mean of 10 and standard deviation of 2
-* Parameters:
-*    mu - double - mean of the normal distribution
-*    sigma - double - standard deviation of the distribution
-********************************************************************************************************************************************************/
-
-double normal (double mu, double sigma) { 
-  double U1, U2, W, mult;
-  static double X1, X2;                                                                     // scalars generated that can be applied to the std
-  static int call = 0;                                                                      // static flag that indicates a second value is available
- 
-  if (call == 1)                                                                            // flag indicates the second scalar is still available
-    {
-      call = !call;
-      return (mu + sigma * (double) X2);                                                    // no need to generate two new scalars, simply return second
-    }
- 
-  do                                                                                        // generate scalars, part of the Polars method 
-    {
-      U1 = -1 + ((double) rand () / RAND_MAX) * 2;
-      U2 = -1 + ((double) rand () / RAND_MAX) * 2;
-      W = pow (U1, 2) + pow (U2, 2);
-    }
-  while (W >= 1 || W == 0);
- 
-  mult = sqrt ((-2 * log (W)) / W);                                                         // multiplier calculated, scalar against two U values calculated above
-  X1 = U1 * mult;                                                                           // Assign first scalar for standard deviation
-  X2 = U2 * mult;                                                                           // Assign second scalar for standard deviation
- 
-  call = !call;                                                                             // indicate that generation is/is not needed
- 
-  return (mu + sigma * (double) X1);                                                        // return the first normally distributed value
+* int createLockstep (Lockstep *lockstep, int minSize, int maxSize)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates the state of one configuration per working set size minSize..maxSize, at most 64 of them. The frames of every
+                configuration are stored back to back in one array, padded to a multiple of 64 frames, so a single sweep over it compares a page
+                with every frame of every configuration. Returns 0, or -1 if there are more than 64 configurations or memory could not be
+                allocated
+* Parameters:
+*    lockstep - Lockstep* - state being created
+*    minSize - int - smallest working set size
+*    maxSize - int - largest working set size
+********************************************************************************************************************************************************/
+
+int createLockstep(Lockstep *lockstep, int minSize, int maxSize) {
+    int configurations = maxSize - minSize + 1;
+    if (configurations > 64) { return -1; }                                             // configurations must fit one 64 bit mask
+    size_t frames = 0;                                                                  // frames of all configurations together
+    for (int size = minSize; size <= maxSize; size++) { frames += size; }
+    lockstep->configurations = configurations;
+    lockstep->words = (frames + 63) / 64;
+    lockstep->sizes = malloc(configurations * sizeof(int));
+    lockstep->offsets = malloc(configurations * sizeof(int));
+    lockstep->owners = malloc(frames);
+    lockstep->filled = malloc(configurations * sizeof(int));
+    lockstep->hands = malloc(configurations * sizeof(int));
+    lockstep->frames = calloc(lockstep->words * 64, sizeof(int));                       // padding frames are never marked valid
+    lockstep->useBits = malloc(lockstep->words * 64 * sizeof(int));
+    lockstep->valid = malloc(lockstep->words * sizeof(uint64_t));
+    lockstep->hits = malloc(lockstep->words * sizeof(uint64_t));
+    if (lockstep->sizes == NULL || lockstep->offsets == NULL || lockstep->owners == NULL || lockstep->filled == NULL || lockstep->hands == NULL
+            || lockstep->frames == NULL || lockstep->useBits == NULL || lockstep->valid == NULL || lockstep->hits == NULL) {
+        freeLockstep(lockstep);
+        return -1;
+    }
+    for (int configuration = 0, offset = 0; configuration < configurations; configuration++) {
+        lockstep->sizes[configuration] = minSize + configuration;
+        lockstep->offsets[configuration] = offset;
+        for (int frame = 0; frame < minSize + configuration; frame++) { lockstep->owners[offset++] = configuration; }
+    }
+#ifdef HAVE_AVX2
+    lockstep->useAVX2 = __builtin_cpu_supports("avx2");
+#else
+    lockstep->useAVX2 = 0;
+#endif
+    resetLockstep(lockstep);
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void resetLockstep (Lockstep *lockstep)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  empties the working set of every configuration and moves every hand back to its first frame
+* Parameters:
+*    lockstep - Lockstep* - state being reset
+********************************************************************************************************************************************************/
+
+void resetLockstep(Lockstep *lockstep) {
+    for (int configuration = 0; configuration < lockstep->configurations; configuration++) {
+        lockstep->filled[configuration] = 0;
+        lockstep->hands[configuration] = 0;
+    }
+    memset(lockstep->valid, 0, lockstep->words * sizeof(uint64_t));
+}
+
+/********************************************************************************************************************************************************
+* void freeLockstep (Lockstep *lockstep)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the state of a lockstep simulation
+* Parameters:
+*    lockstep - Lockstep* - state being released
+********************************************************************************************************************************************************/
+
+void freeLockstep(Lockstep *lockstep) {
+    free(lockstep->sizes);
+    free(lockstep->offsets);
+    free(lockstep->owners);
+    free(lockstep->filled);
+    free(lockstep->hands);
+    free(lockstep->frames);
+    free(lockstep->useBits);
+    free(lockstep->valid);
+    free(lockstep->hits);
+    memset(lockstep, 0, sizeof(Lockstep));
+}
+
+/********************************************************************************************************************************************************
+* void lockstepFIFO (Lockstep *lockstep, TraceSource *trace, long long length, long long *faults)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  runs FIFO for every configuration over a single pass of the data set. Each page number is compared with all frames at once, then
+                every configuration that misses it fills its next free frame or replaces the frame at its head, exactly as FIFO does. The
+                page faults of each configuration are added to faults
+* Parameters:
+*    lockstep - Lockstep* - state of the configurations, reset by the call
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    faults - long long* - resultant array, one entry per configuration
+********************************************************************************************************************************************************/
+
+void lockstepFIFO(Lockstep *lockstep, TraceSource *trace, long long length, long long *faults) {
+    resetLockstep(lockstep);
+    COUNT_PASS();
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {
+            matchFrames(lockstep, data[i]);                                             // find the page in every configuration at once
+            uint64_t missed = missedConfigurations(lockstep, NULL);
+            COUNT_REFERENCE(data[i]);
+            COUNT_HITS(POLICY_FIFO, lockstep->configurations - __builtin_popcountll(missed));
+            for (; missed != 0; missed &= missed - 1) {                                 // only configurations missing the page change
+                int configuration = __builtin_ctzll(missed);
+                int size = lockstep->sizes[configuration];
+                int frame = 0;
+                COUNT_MISS(POLICY_FIFO);
+                if (lockstep->filled[configuration] < size) { frame = lockstep->filled[configuration]++; }
+                else {                                                                  // working set full, replace the head
+                    COUNT_FAULT(POLICY_FIFO);
+                    frame = lockstep->hands[configuration];
+                    lockstep->hands[configuration] = frame + 1 < size ? frame + 1 : 0;
+                    faults[configuration]++;
+                }
+                frame += lockstep->offsets[configuration];
+                lockstep->frames[frame] = data[i];
+                lockstep->valid[frame / 64] |= 1ULL << (frame % 64);
+            }
+        }
+    }
+}
+
+/********************************************************************************************************************************************************
+* void lockstepClock (Lockstep *lockstep, TraceSource *trace, long long length, long long *faults)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  runs Clock in CLOCK_HAND mode for every configuration over a single pass of the data set. Each page number is compared with all
+                frames at once, the frames holding it get their use-bit set and every configuration that misses it fills its next free frame or
+                replaces the frame its hand stops at, exactly as Clock does. The page faults of each configuration are added to faults
+* Parameters:
+*    lockstep - Lockstep* - state of the configurations, reset by the call
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    faults - long long* - resultant array, one entry per configuration
+********************************************************************************************************************************************************/
+
+void lockstepClock(Lockstep *lockstep, TraceSource *trace, long long length, long long *faults) {
+    resetLockstep(lockstep);
+    COUNT_PASS();
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {
+            matchFrames(lockstep, data[i]);                                             // find the page in every configuration at once
+            uint64_t missed = missedConfigurations(lockstep, lockstep->useBits);        // frames holding the page get a second-life
+            COUNT_REFERENCE(data[i]);
+            COUNT_HITS(POLICY_CLOCK, lockstep->configurations - __builtin_popcountll(missed));
+            for (; missed != 0; missed &= missed - 1) {                                 // only configurations missing the page change
+                int configuration = __builtin_ctzll(missed);
+                int offset = lockstep->offsets[configuration];
+                int size = lockstep->sizes[configuration];
+                int frame = 0;
+                COUNT_MISS(POLICY_CLOCK);
+                if (lockstep->filled[configuration] < size) { frame = lockstep->filled[configuration]++; }
+                else {                                                                  // working set full, move the hand to the first 0 use-bit
+                    COUNT_FAULT(POLICY_CLOCK);
+                    frame = getClockIndex(size, lockstep->useBits + offset, &lockstep->hands[configuration]);
+                    faults[configuration]++;
+                }
+                frame += offset;
+                lockstep->frames[frame] = data[i];
+                lockstep->useBits[frame] = 0;                                           // use-bit of a page just added is set to 0
+                lockstep->valid[frame / 64] |= 1ULL << (frame % 64);
+            }
+        }
+    }
+}
+
+/********************************************************************************************************************************************************
+* void matchFrames (Lockstep *lockstep, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  sets the bit of every frame, across all configurations, that holds the page. Frames that never received a page are masked out by
+                their valid bit, so no page number has to be reserved as empty. Uses matchFramesAVX2 when the processor supports it
+* Parameters:
+*    lockstep - Lockstep* - state of the configurations, its hits are overwritten
+*    page - int - page number being referenced
+********************************************************************************************************************************************************/
+
+void matchFrames(Lockstep *lockstep, int page) {
+#ifdef HAVE_AVX2
+    if (lockstep->useAVX2) {
+        matchFramesAVX2(lockstep, page);
+        return;
+    }
+#endif
+    for (int word = 0; word < lockstep->words; word++) {
+        const int *frames = lockstep->frames + word * 64;
+        uint64_t bits = 0;
+        for (int frame = 0; frame < 64; frame++) { bits |= (uint64_t) (frames[frame] == page) << frame; }
+        lockstep->hits[word] = bits & lockstep->valid[word];
+    }
+}
+
+#ifdef HAVE_AVX2
+/********************************************************************************************************************************************************
+* void matchFramesAVX2 (Lockstep *lockstep, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  same as matchFrames, comparing 8 frames per AVX2 instruction and collecting the results with a movemask. Only called once the
+                processor is known to support AVX2
+* Parameters:
+*    lockstep - Lockstep* - state of the configurations, its hits are overwritten
+*    page - int - page number being referenced
+********************************************************************************************************************************************************/
+
+__attribute__((target("avx2")))
+void matchFramesAVX2(Lockstep *lockstep, int page) {
+    __m256i wanted = _mm256_set1_epi32(page);
+    for (int word = 0; word < lockstep->words; word++) {
+        const __m256i *frames = (const __m256i *) (lockstep->frames + word * 64);
+        uint64_t bits = 0;
+        for (int chunk = 0; chunk < 8; chunk++) {                                       // 8 frames per compare, 8 compares per word
+            __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(frames + chunk), wanted);
+            bits |= (uint64_t) (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(equal)) << (8 * chunk);
+        }
+        lockstep->hits[word] = bits & lockstep->valid[word];
+    }
+}
+#endif
+
+/********************************************************************************************************************************************************
+* uint64_t missedConfigurations (Lockstep *lockstep, int *useBits)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns a mask with the bit of every configuration that has no frame holding the page matched last. Only the frames that matched
+                are visited, since a page is held by at most one frame per configuration. If useBits is given the use-bit of every frame that
+                matched is set on the way
+* Parameters:
+*    lockstep - Lockstep* - state of the configurations
+*    useBits - int* - use-bit set given, NULL if the policy keeps none
+********************************************************************************************************************************************************/
+
+uint64_t missedConfigurations(Lockstep *lockstep, int *useBits) {
+    uint64_t all = lockstep->configurations == 64 ? ~0ULL : (1ULL << lockstep->configurations) - 1;
+    uint64_t held = 0;                                                                  // configurations holding the page
+    for (int word = 0; word < lockstep->words; word++) {
+        for (uint64_t bits = lockstep->hits[word]; bits != 0; bits &= bits - 1) {       // visit every frame holding the page
+            int frame = word * 64 + __builtin_ctzll(bits);
+            held |= 1ULL << lockstep->owners[frame];
+            if (useBits != NULL) { useBits[frame] = 1; }
+        }
+    }
+    return all & ~held;
+}
+
+/********************************************************************************************************************************************************
+* int createRecencyList (RecencyList *list, int size)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty recency list able to link the given number of frames. Returns 0, or -1 if memory could not be allocated
+* Parameters:
+*    list - RecencyList* - list being created
+*    size - int - number of frames
+********************************************************************************************************************************************************/
+
+int createRecencyList(RecencyList *list, int size) {
+    list->older = malloc(size * sizeof(int));
+    list->newer = malloc(size * sizeof(int));
+    list->oldest = -1;                                                                  // -1 marks the end of the list
+    list->newest = -1;
+    if (list->older == NULL || list->newer == NULL) {
+        freeRecencyList(list);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void appendFrame (RecencyList *list, int frame)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  links a frame that is not in the list as the most recently used one
+* Parameters:
+*    list - RecencyList* - list the frame is linked into
+*    frame - int - index of the frame
+********************************************************************************************************************************************************/
+
+void appendFrame(RecencyList *list, int frame) {
+    list->older[frame] = list->newest;
+    list->newer[frame] = -1;
+    if (list->newest != -1) { list->newer[list->newest] = frame; }
+    else { list->oldest = frame; }                                                      // list was empty, frame is also the oldest
+    list->newest = frame;
+}
+
+/********************************************************************************************************************************************************
+* void unlinkFrame (RecencyList *list, int frame)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  takes a frame out of the list, joining its older and newer neighbours
+* Parameters:
+*    list - RecencyList* - list the frame is linked into
+*    frame - int - index of the frame
+********************************************************************************************************************************************************/
+
+void unlinkFrame(RecencyList *list, int frame) {
+    int older = list->older[frame];
+    int newer = list->newer[frame];
+    if (older != -1) { list->newer[older] = newer; }
+    else { list->oldest = newer; }                                                      // frame was the oldest
+    if (newer != -1) { list->older[newer] = older; }
+    else { list->newest = older; }                                                      // frame was the newest
+}
+
+/********************************************************************************************************************************************************
+* void freeRecencyList (RecencyList *list)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the links of a recency list
+* Parameters:
+*    list - RecencyList* - list being released
+********************************************************************************************************************************************************/
+
+void freeRecencyList(RecencyList *list) {
+    free(list->older);
+    free(list->newer);
+    list->older = NULL;
+    list->newer = NULL;
+}
+
+/********************************************************************************************************************************************************
+* int createNextUseHeap (NextUseHeap *heap, int size)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty heap for frames 0..size-1. Returns 0, or -1 if memory could not be allocated
+* Parameters:
+*    heap - NextUseHeap* - heap being created
+*    size - int - number of frames the heap can hold
+********************************************************************************************************************************************************/
+
+int createNextUseHeap(NextUseHeap *heap, int size) {
+    heap->heap = malloc(size * sizeof(int));
+    heap->positions = malloc(size * sizeof(int));
+    heap->keys = malloc(size * sizeof(long long));
+    heap->count = 0;
+    if (heap->heap == NULL || heap->positions == NULL || heap->keys == NULL) {
+        freeNextUseHeap(heap);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void pushFrame (NextUseHeap *heap, int frame, long long key)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  adds a frame that is not in the heap yet with the time of the next reference to its page
+* Parameters:
+*    heap - NextUseHeap* - heap the frame is added to
+*    frame - int - index of the frame
+*    key - long long - time of the next reference to the frame's page
+********************************************************************************************************************************************************/
+
+void pushFrame(NextUseHeap *heap, int frame, long long key) {
+    heap->heap[heap->count] = frame;                                                    // start as the last leaf and let updateFrame move it up
+    heap->positions[frame] = heap->count++;
+    updateFrame(heap, frame, key);
+}
+
+/********************************************************************************************************************************************************
+* void updateFrame (NextUseHeap *heap, int frame, long long key)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  changes the next reference time of a frame in the heap, moving it up past parents referenced sooner or down past children
+                referenced later so the root stays the frame referenced furthest ahead
+* Parameters:
+*    heap - NextUseHeap* - heap holding the frame
+*    frame - int - index of the frame
+*    key - long long - new time of the next reference to the frame's page
+********************************************************************************************************************************************************/
+
+void updateFrame(NextUseHeap *heap, int frame, long long key) {
+    int position = heap->positions[frame];
+    heap->keys[frame] = key;
+    while (position > 0 && heap->keys[heap->heap[(position - 1) / 2]] < key) {         // parent is referenced sooner, swap it down
+        int parent = heap->heap[(position - 1) / 2];
+        heap->heap[position] = parent;
+        heap->positions[parent] = position;
+        position = (position - 1) / 2;
+    }
+    for (;;) {
+        int child = 2 * position + 1;                                                   // later referenced child, if any is later than the frame
+        if (child >= heap->count) { break; }
+        if (child + 1 < heap->count && heap->keys[heap->heap[child + 1]] > heap->keys[heap->heap[child]]) { child++; }
+        if (heap->keys[heap->heap[child]] <= key) { break; }
+        heap->heap[position] = heap->heap[child];
+        heap->positions[heap->heap[child]] = position;
+        position = child;
+    }
+    heap->heap[position] = frame;
+    heap->positions[frame] = position;
+}
+
+/********************************************************************************************************************************************************
+* void freeNextUseHeap (NextUseHeap *heap)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the arrays of a next use heap
+* Parameters:
+*    heap - NextUseHeap* - heap being released
+********************************************************************************************************************************************************/
+
+void freeNextUseHeap(NextUseHeap *heap) {
+    free(heap->heap);
+    free(heap->positions);
+    free(heap->keys);
+    heap->heap = NULL;
+    heap->positions = NULL;
+    heap->keys = NULL;
+}
+
+/********************************************************************************************************************************************************
+* void stackDistances (TraceSource *trace, long long length, StackHistogram *histogram)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  adds the LRU stack distance of every reference in the data set to the histogram (Mattson et al.). The stack distance of a
+                re-reference is the number of distinct pages referenced since the previous reference to the same page, itself included, so an
+                LRU working set of size frames faults on it exactly when the distance is greater than frames. The last reference time of every
+                page is kept in a hash table and a Fenwick tree over reference times marks the times that are still some page's last
+                reference, so counting the distinct pages in between costs O(log n). Once the tree runs out of times they are renumbered by
+                compactTimes, keeping memory proportional to the distinct pages rather than the trace length. First references are recorded by
+                how many distinct pages the trace has seen so far, since the j-th distinct page only faults once the j-1 pages before it
+                already fill the working set
+* Parameters:
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    histogram - StackHistogram* - histogram the distances are added to
+********************************************************************************************************************************************************/
+
+void stackDistances(TraceSource *trace, long long length, StackHistogram *histogram) {
+    int beyond = histogram->maxFrames + 1;                                              // bucket holding every distance larger than maxFrames
+    int distinct = 0;                                                                   // number of distinct pages referenced so far
+    int time = 0;                                                                       // reference time of the latest page number
+    int capacity = TRACE_BLOCK;                                                         // number of times the Fenwick tree can mark
+    PageTable lastReference;                                                            // time of the latest reference to every page
+    int *tree = calloc(capacity + 1, sizeof(int));                                      // Fenwick tree over times 1..capacity, 1 marks a last reference
+    if (tree == NULL || createPageTable(&lastReference, capacity) != 0) {
+        fprintf(stderr, "stackDistances: out of memory\n");
+        exit(1);
+    }
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    COUNT_PASS();
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        for (int i = 0; i < count; i++) {                                               // iterate over each page number in the block
+            COUNT_REFERENCE(data[i]);
+            if (time == capacity) {                                                     // every time is used, renumber the last references 1..distinct
+                tree = compactTimes(&lastReference, tree, &capacity);
+                time = distinct;
+            }
+            time++;
+            int *previous = findPage(&lastReference, data[i]);                          // time of the previous reference to the page, if any
+            if (previous == NULL) {                                                     // first reference to the page
+                COUNT_MISS(POLICY_STACK);
+                distinct++;
+                histogram->first[distinct < beyond ? distinct : beyond]++;
+                insertPage(&lastReference, data[i], time);
+            }
+            else {
+                COUNT_HITS(POLICY_STACK, 1);                                            // re-references, hits of an unbounded working set
+                int older = 0;                                                          // marks at or before the previous reference, pages not
+                for (int j = *previous; j > 0; j -= j & -j) { older += tree[j]; }       // referenced since then
+                int distance = distinct - older + 1;                                    // pages referenced since then, plus the page itself
+                histogram->reuse[distance < beyond ? distance : beyond]++;
+                for (int j = *previous; j <= capacity; j += j & -j) { tree[j]--; }      // previous reference is no longer the page's last one
+                *previous = time;
+            }
+            for (int j = time; j <= capacity; j += j & -j) { tree[j]++; }               // mark the current time as the page's last reference
+        }
+    }
+    freePageTable(&lastReference);
+    free(tree);
+}
+
+/********************************************************************************************************************************************************
+* long long getHistogramFaults (StackHistogram *histogram, int size)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns the number of page faults an LRU working set of the given size encounters over every trace added to the histogram. These
+                are the re-references with a stack distance greater than size, plus the first references made once size distinct pages
+                already fill the working set
+* Parameters:
+*    histogram - StackHistogram* - histogram of the traces
+*    size - int - size of the working set, at most the histogram's maxFrames
+********************************************************************************************************************************************************/
+
+long long getHistogramFaults(StackHistogram *histogram, int size) {
+    long long faults = 0;                                                               // set the default number of faults to 0
+    for (int distance = size + 1; distance <= histogram->maxFrames + 1; distance++) {   // every bucket beyond the working set size faults
+        faults += histogram->reuse[distance] + histogram->first[distance];
+    }
+    return faults;                                                                      // return sum of faults of the buckets
+}
+
+/********************************************************************************************************************************************************
+* int createHistogram (StackHistogram *histogram, int maxFrames)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty histogram with a bucket for every distance 1..maxFrames and one for all larger distances. Returns 0, or -1 if
+                memory could not be allocated
+* Parameters:
+*    histogram - StackHistogram* - histogram being created
+*    maxFrames - int - largest working set size the histogram can answer for
+********************************************************************************************************************************************************/
+
+int createHistogram(StackHistogram *histogram, int maxFrames) {
+    histogram->maxFrames = maxFrames;
+    histogram->reuse = calloc(maxFrames + 2, sizeof(long long));                        // index 0 unused, maxFrames+1 collects larger distances
+    histogram->first = calloc(maxFrames + 2, sizeof(long long));
+    if (histogram->reuse == NULL || histogram->first == NULL) {
+        freeHistogram(histogram);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void freeHistogram (StackHistogram *histogram)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the buckets of a histogram
+* Parameters:
+*    histogram - StackHistogram* - histogram being released
+********************************************************************************************************************************************************/
+
+void freeHistogram(StackHistogram *histogram) {
+    free(histogram->reuse);
+    free(histogram->first);
+    histogram->reuse = NULL;
+    histogram->first = NULL;
+}
+
+/********************************************************************************************************************************************************
+* void sampleDistances (TraceSource *trace, long long length, int budget, SampledHistogram *histogram)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  replaces the histogram with the estimated LRU stack distances of the data set, from a spatially hashed sample of its pages
+                (SHARDS, Waldspurger et al.). A page is sampled when sampleHash puts it below a threshold, so every reference to a sampled page
+                is seen and stack distances among sampled pages are measured exactly, as in stackDistances, then scaled by 1/rate. The
+                threshold starts at the whole hash space and the sample keeps at most budget pages: once it holds more, the pages with the
+                largest hash are dropped, the threshold falls to that hash and the buckets counted so far are rescaled to the new rate. A
+                first reference is put at the estimated number of distinct pages seen so far, the sampled ones divided by the rate. At the end
+                the difference between the references expected at the final rate and those counted is added to the shortest distance
+                (SHARDS-adj), so the estimate keeps the trace's reference count. The hash table, heap and Fenwick tree never hold more than
+                budget+1 pages, so memory does not grow with the trace length or the number of distinct pages
+* Parameters:
+*    trace - TraceSource* - trace source the data set is read from
+*    length - long long - number of page numbers read from the trace source
+*    budget - int - most pages kept in the sample
+*    histogram - SampledHistogram* - histogram being replaced
+********************************************************************************************************************************************************/
+
+void sampleDistances(TraceSource *trace, long long length, int budget, SampledHistogram *histogram) {
+    int beyond = histogram->maxFrames + 1;                                              // bucket holding every distance larger than maxFrames
+    double threshold = SAMPLE_SPACE;                                                    // pages hashing below the threshold are sampled
+    long long references = 0;                                                           // number of page numbers read
+    double counted = 0;                                                                 // sampled references counted, scaled to the current rate
+    int time = 0;                                                                       // reference time of the latest sampled page number
+    int capacity = TRACE_BLOCK;                                                         // number of times the Fenwick tree can mark
+    PageTable lastReference;                                                            // time of the latest reference to every sampled page
+    SampleHeap sample;                                                                  // sampled pages, largest hash first
+    int *tree = calloc(capacity + 1, sizeof(int));                                      // Fenwick tree over times 1..capacity, 1 marks a last reference
+    if (tree == NULL || createPageTable(&lastReference, budget + 1) != 0 || createSampleHeap(&sample, budget + 1) != 0) {
+        fprintf(stderr, "sampleDistances: out of memory\n");
+        exit(1);
+    }
+    for (int bucket = 0; bucket <= beyond; bucket++) { histogram->reuse[bucket] = histogram->first[bucket] = 0; }
+    histogram->rate = 1;
+    const int *data;                                                                    // block of the data set currently being processed
+    int count;                                                                          // number of page numbers in the block
+    for (long long read = 0; read < length && (count = readTrace(trace, &data, length - read)) > 0; read += count) {
+        references += count;
+        for (int i = 0; i < count; i++) {                                               // iterate over each page number in the block
+            uint32_t hash = sampleHash(data[i]);
+            if (hash >= threshold) { continue; }                                        // page is not sampled
+            if (time == capacity) {                                                     // every time is used, renumber the last references
+                tree = compactTimes(&lastReference, tree, &capacity);
+                time = lastReference.count;
+            }
+            time++;
+            counted++;
+            int *previous = findPage(&lastReference, data[i]);                          // time of the previous reference to the page, if any
+            if (previous == NULL) {                                                     // first reference to the page
+                insertPage(&lastReference, data[i], time);
+                pushSample(&sample, hash, data[i]);
+                double distinct = lastReference.count / histogram->rate;                // distinct pages of the whole trace seen so far
+                histogram->first[distinct < beyond ? (int) (distinct + 0.5) : beyond]++;
+            }
+            else {
+                int older = 0;                                                          // marks at or before the previous reference, sampled
+                for (int j = *previous; j > 0; j -= j & -j) { older += tree[j]; }       // pages not referenced since then
+                double distance = (lastReference.count - older + 1) / histogram->rate;  // scaled to the pages of the whole trace
+                histogram->reuse[distance < beyond ? (int) (distance + 0.5) : beyond]++;
+                for (int j = *previous; j <= capacity; j += j & -j) { tree[j]--; }      // previous reference is no longer the page's last one
+                *previous = time;
+            }
+            for (int j = time; j <= capacity; j += j & -j) { tree[j]++; }               // mark the current time as the page's last reference
+            if (lastReference.count <= budget) { continue; }
+            threshold = sample.hashes[0];                                               // sample is over budget, lower the threshold to the
+            while (sample.count > 0 && sample.hashes[0] >= threshold) {                 // largest hash and drop every page at or above it
+                int page = popSample(&sample);
+                int *last = findPage(&lastReference, page);
+                for (int j = *last; j <= capacity; j += j & -j) { tree[j]--; }
+                removePage(&lastReference, page);
+            }
+            double scale = threshold / SAMPLE_SPACE / histogram->rate;                  // counts so far as if sampled at the new rate
+            for (int bucket = 0; bucket <= beyond; bucket++) {
+                histogram->reuse[bucket] *= scale;
+                histogram->first[bucket] *= scale;
+            }
+            counted *= scale;
+            histogram->rate = threshold / SAMPLE_SPACE;
+        }
+    }
+    histogram->reuse[1] += references * histogram->rate - counted;                      // SHARDS-adj, restore the expected reference count
+    histogram->references = references;
+    freePageTable(&lastReference);
+    freeSampleHeap(&sample);
+    free(tree);
+}
+
+/********************************************************************************************************************************************************
+* double getSampledFaults (SampledHistogram *histogram, int size)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns the estimated number of page faults an LRU working set of the given size encounters over the data set of the histogram,
+                the sampled references in every bucket beyond size divided by the sampling rate. When more sampled references were counted
+                than the rate predicts, the SHARDS-adj correction of the shortest distance is negative and cannot take them back out of the
+                longer ones, so the estimate is capped at the data set's reference count
+* Parameters:
+*    histogram - SampledHistogram* - histogram of the data set
+*    size - int - size of the working set, at most the histogram's maxFrames
+********************************************************************************************************************************************************/
+
+double getSampledFaults(SampledHistogram *histogram, int size) {
+    double faults = 0;                                                                  // set the default number of faults to 0
+    for (int distance = size + 1; distance <= histogram->maxFrames + 1; distance++) {   // every bucket beyond the working set size faults
+        faults += histogram->reuse[distance] + histogram->first[distance];
+    }
+    faults /= histogram->rate;                                                          // sum of faults of the buckets, unsampled
+    return faults < histogram->references ? faults : histogram->references;             // never more faults than references
+}
+
+/********************************************************************************************************************************************************
+* int createSampledHistogram (SampledHistogram *histogram, int maxFrames)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty sampled histogram with a bucket for every distance 1..maxFrames and one for all larger distances. Returns 0,
+                or -1 if memory could not be allocated
+* Parameters:
+*    histogram - SampledHistogram* - histogram being created
+*    maxFrames - int - largest working set size the histogram can answer for
+********************************************************************************************************************************************************/
+
+int createSampledHistogram(SampledHistogram *histogram, int maxFrames) {
+    histogram->maxFrames = maxFrames;
+    histogram->rate = 1;
+    histogram->references = 0;
+    histogram->reuse = calloc(maxFrames + 2, sizeof(double));                           // index 0 unused, maxFrames+1 collects larger distances
+    histogram->first = calloc(maxFrames + 2, sizeof(double));
+    if (histogram->reuse == NULL || histogram->first == NULL) {
+        freeSampledHistogram(histogram);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void freeSampledHistogram (SampledHistogram *histogram)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the buckets of a sampled histogram
+* Parameters:
+*    histogram - SampledHistogram* - histogram being released
+********************************************************************************************************************************************************/
+
+void freeSampledHistogram(SampledHistogram *histogram) {
+    free(histogram->reuse);
+    free(histogram->first);
+    histogram->reuse = NULL;
+    histogram->first = NULL;
+}
+
+/********************************************************************************************************************************************************
+* uint32_t sampleHash (int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns a well mixed 32 bit hash of the page number (MurmurHash3 finalizer). Neighbouring page numbers land far apart, so the
+                pages below any threshold are a uniform spatial sample. Unlike the page table hash every bit is mixed, since the threshold
+                compares the whole value
+* Parameters:
+*    page - int - page number being hashed
+********************************************************************************************************************************************************/
+
+uint32_t sampleHash(int page) {
+    uint32_t hash = (uint32_t) page;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/********************************************************************************************************************************************************
+* int createSampleHeap (SampleHeap *heap, int size)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty heap for up to size sampled pages. Returns 0, or -1 if memory could not be allocated
+* Parameters:
+*    heap - SampleHeap* - heap being created
+*    size - int - most sampled pages the heap holds
+********************************************************************************************************************************************************/
+
+int createSampleHeap(SampleHeap *heap, int size) {
+    heap->hashes = malloc(size * sizeof(uint32_t));
+    heap->pages = malloc(size * sizeof(int));
+    heap->count = 0;
+    if (heap->hashes == NULL || heap->pages == NULL) {
+        freeSampleHeap(heap);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* void pushSample (SampleHeap *heap, uint32_t hash, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  adds a sampled page, moving it up past parents with a smaller hash
+* Parameters:
+*    heap - SampleHeap* - heap the page is added to
+*    hash - uint32_t - sample hash of the page
+*    page - int - page number being added
+********************************************************************************************************************************************************/
+
+void pushSample(SampleHeap *heap, uint32_t hash, int page) {
+    int position = heap->count++;
+    while (position > 0 && heap->hashes[(position - 1) / 2] < hash) {                  // parent hashes lower, swap it down
+        heap->hashes[position] = heap->hashes[(position - 1) / 2];
+        heap->pages[position] = heap->pages[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    heap->hashes[position] = hash;
+    heap->pages[position] = page;
+}
+
+/********************************************************************************************************************************************************
+* int popSample (SampleHeap *heap)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  removes the sampled page with the largest hash and returns its page number, moving the last page down from the root to refill it
+* Parameters:
+*    heap - SampleHeap* - heap holding at least one page
+********************************************************************************************************************************************************/
+
+int popSample(SampleHeap *heap) {
+    int page = heap->pages[0];
+    uint32_t hash = heap->hashes[--heap->count];                                        // last page, placed where the heap order allows
+    int last = heap->pages[heap->count];
+    int position = 0;
+    for (;;) {
+        int child = 2 * position + 1;                                                   // child with the larger hash, if any is larger
+        if (child >= heap->count) { break; }
+        if (child + 1 < heap->count && heap->hashes[child + 1] > heap->hashes[child]) { child++; }
+        if (heap->hashes[child] <= hash) { break; }
+        heap->hashes[position] = heap->hashes[child];
+        heap->pages[position] = heap->pages[child];
+        position = child;
+    }
+    heap->hashes[position] = hash;
+    heap->pages[position] = last;
+    return page;
+}
+
+/********************************************************************************************************************************************************
+* void freeSampleHeap (SampleHeap *heap)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the arrays of a sample heap
+* Parameters:
+*    heap - SampleHeap* - heap being released
+********************************************************************************************************************************************************/
+
+void freeSampleHeap(SampleHeap *heap) {
+    free(heap->hashes);
+    free(heap->pages);
+    heap->hashes = NULL;
+    heap->pages = NULL;
+}
+
+/********************************************************************************************************************************************************
+* int createPageTable (PageTable *table, int expected)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  allocates an empty open-addressing hash table from page number to int value, large enough to hold the expected number of page
+                numbers at a load factor of at most 1/2. Returns 0, or -1 if memory could not be allocated
+* Parameters:
+*    table - PageTable* - table being created
+*    expected - int - number of page numbers expected to be stored
+********************************************************************************************************************************************************/
+
+int createPageTable(PageTable *table, int expected) {
+    table->capacity = 16;
+    table->shift = 28;
+    while (table->capacity < 2 * expected) {                                            // keep the load factor at or below 1/2
+        table->capacity *= 2;
+        table->shift--;
+    }
+    table->count = 0;
+    table->keys = malloc(table->capacity * sizeof(int));
+    table->values = malloc(table->capacity * sizeof(int));
+    table->used = calloc(table->capacity, 1);                                           // every slot starts empty
+    if (table->keys == NULL || table->values == NULL || table->used == NULL) {
+        freePageTable(table);
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* unsigned getHomeSlot (PageTable *table, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns the slot the probe run of a page number starts from, the top log2(capacity) bits of its multiplicative hash. The low
+                bits of the product only depend on the low bits of the page number, so strided page numbers such as multiples of 16384 would
+                all share a handful of slots if those were used instead
+* Parameters:
+*    table - PageTable* - table the page number belongs to
+*    page - int - page number being hashed
+********************************************************************************************************************************************************/
+
+unsigned getHomeSlot(PageTable *table, int page) {
+    return ((unsigned) page * 0x9E3779B1u) >> table->shift;
+}
+
+/********************************************************************************************************************************************************
+* int *findPage (PageTable *table, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns a pointer to the value stored for the page number, NULL if the page number is not in the table. Slots are probed linearly
+                from the page number's home slot
+* Parameters:
+*    table - PageTable* - table we are searching in
+*    page - int - page number we're querying for
+********************************************************************************************************************************************************/
+
+int *findPage(PageTable *table, int page) {
+    unsigned mask = table->capacity - 1;
+    unsigned home = getHomeSlot(table, page);                                           // slot the probe run starts from
+    unsigned slot = home;
+    while (table->used[slot]) {                                                         // probe until an empty slot ends the run
+        if (table->keys[slot] == page) {                                                // return value where it was found
+            COUNT_PROBES(((slot - home) & mask) + 1);
+            return &table->values[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    COUNT_PROBES(((slot - home) & mask) + 1);                                           // the empty slot ending the run was probed too
+    return NULL;                                                                        // return NULL for couldn't find
+}
+
+/********************************************************************************************************************************************************
+* void insertPage (PageTable *table, int page, int value)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  stores the value for a page number that is not in the table yet, doubling the table once it is half full. Exits the program if
+                the larger table cannot be allocated, since none of the callers can carry on with the page number missing
+* Parameters:
+*    table - PageTable* - table the page number is added to
+*    page - int - page number being added
+*    value - int - value stored for the page number
+********************************************************************************************************************************************************/
+
+void insertPage(PageTable *table, int page, int value) {
+    if (2 * (table->count + 1) > table->capacity) {                                     // table would pass a load factor of 1/2, grow it
+        PageTable larger;
+        if (createPageTable(&larger, table->count + 1) != 0) {
+            fprintf(stderr, "insertPage: out of memory\n");
+            exit(1);
+        }
+        for (int slot = 0; slot < table->capacity; slot++) {                            // move every stored page number into the larger table
+            if (table->used[slot]) { insertPage(&larger, table->keys[slot], table->values[slot]); }
+        }
+        freePageTable(table);
+        *table = larger;
+    }
+    unsigned mask = table->capacity - 1;
+    unsigned slot = getHomeSlot(table, page);                                           // slot the probe run starts from
+    while (table->used[slot]) { slot = (slot + 1) & mask; }                             // find the first empty slot of the run
+    table->keys[slot] = page;
+    table->values[slot] = value;
+    table->used[slot] = 1;
+    table->count++;
+}
+
+/********************************************************************************************************************************************************
+* void removePage (PageTable *table, int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  removes a page number from the table if it is stored. The page numbers after it in the same probe run are shifted back into the
+                freed slot when their hash allows it, so lookups never need tombstones
+* Parameters:
+*    table - PageTable* - table the page number is removed from
+*    page - int - page number being removed
+********************************************************************************************************************************************************/
+
+void removePage(PageTable *table, int page) {
+    unsigned mask = table->capacity - 1;
+    unsigned slot = getHomeSlot(table, page);                                           // slot the probe run starts from
+    while (table->used[slot] && table->keys[slot] != page) { slot = (slot + 1) & mask; }
+    if (!table->used[slot]) { return; }                                                 // page number is not stored
+    unsigned hole = slot;                                                               // slot that has to be filled or left empty
+    for (slot = (slot + 1) & mask; table->used[slot]; slot = (slot + 1) & mask) {       // walk the rest of the probe run
+        unsigned home = getHomeSlot(table, table->keys[slot]);                          // slot the page number hashes to
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {                         // hole lies between home and slot, move it back
+            table->keys[hole] = table->keys[slot];
+            table->values[hole] = table->values[slot];
+            hole = slot;
+        }
+    }
+    table->used[hole] = 0;
+    table->count--;
+}
+
+/********************************************************************************************************************************************************
+* void freePageTable (PageTable *table)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the slots of a table
+* Parameters:
+*    table - PageTable* - table being released
+********************************************************************************************************************************************************/
+
+void freePageTable(PageTable *table) {
+    free(table->keys);
+    free(table->values);
+    free(table->used);
+    table->keys = NULL;
+    table->values = NULL;
+    table->used = NULL;
+}
+
+/********************************************************************************************************************************************************
+* int *compactTimes (PageTable *lastReference, int *tree, int *capacity)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  renumbers the last reference time of every page to 1..distinct pages, keeping their order, and returns a new Fenwick tree marking
+                exactly those times. The tree is grown to at least twice the distinct pages, so the next compaction is at least as many
+                references away as this one costs and each reference still costs O(log n) amortized
+* Parameters:
+*    lastReference - PageTable* - time of the latest reference to every page, updated in place
+*    tree - int* - Fenwick tree being replaced, released by the call
+*    capacity - int* - number of times the tree can mark, updated to the new tree's capacity
+********************************************************************************************************************************************************/
+
+int *compactTimes(PageTable *lastReference, int *tree, int *capacity) {
+    int distinct = lastReference->count;
+    int *rank = tree;                                                                   // old tree is reused to rank the old times
+    memset(rank, 0, (*capacity + 1) * sizeof(int));
+    for (int slot = 0; slot < lastReference->capacity; slot++) {                        // mark every page's last reference time
+        if (lastReference->used[slot]) { rank[lastReference->values[slot]] = 1; }
+    }
+    for (int time = 1; time <= *capacity; time++) { rank[time] += rank[time-1]; }       // new time is the number of marked times up to the old one
+    for (int slot = 0; slot < lastReference->capacity; slot++) {
+        if (lastReference->used[slot]) { lastReference->values[slot] = rank[lastReference->values[slot]]; }
+    }
+    free(rank);
+
+    if (*capacity < 2 * distinct) { *capacity = 2 * distinct; }                        // leave at least as many free times as marked ones
+    tree = calloc(*capacity + 1, sizeof(int));
+    if (tree == NULL) {
+        fprintf(stderr, "stackDistances: out of memory\n");
+        exit(1);
+    }
+    for (int time = 1; time <= *capacity; time++) {                                     // build the tree marking times 1..distinct in O(n)
+        tree[time] += time <= distinct;
+        int parent = time + (time & -time);
+        if (parent <= *capacity) { tree[parent] += tree[time]; }
+    }
+    return tree;
+}
+
+/********************************************************************************************************************************************************
+* void openMemoryTrace (TraceSource *trace, const int *data, long long length)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  creates a trace source over page numbers that are already in memory. Reads hand out blocks of the array itself, nothing is copied
+* Parameters:
+*    trace - TraceSource* - trace source being created
+*    data - const int* - page numbers of the trace
+*    length - long long - number of page numbers
+********************************************************************************************************************************************************/
+
+void openMemoryTrace(TraceSource *trace, const int *data, long long length) {
+    trace->data = data;
+    trace->bytes = NULL;
+    trace->size = 0;
+    trace->length = length;
+    rewindTrace(trace);
+}
+
+/********************************************************************************************************************************************************
+* int openTraceFile (TraceSource *trace, const char *path)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  creates a trace source over a trace file, which is memory-mapped rather than read so the page numbers are only decoded as the
+                replacement algorithms stream through them. A trace file starts with TRACE_MAGIC and the number of page numbers as a
+                little-endian 64 bit integer. Every page number follows as its difference to the previous one (0 before the first), zigzag
+                encoded so small negative differences stay small and written as a base-128 varint. Returns 0, or -1 after reporting why the
+                file cannot be used
+* Parameters:
+*    trace - TraceSource* - trace source being created
+*    path - const char* - path of the trace file
+********************************************************************************************************************************************************/
+
+int openTraceFile(TraceSource *trace, const char *path) {
+    int descriptor = open(path, O_RDONLY);
+    struct stat status;
+    if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+        perror(path);
+        if (descriptor >= 0) { close(descriptor); }
+        return -1;
+    }
+    if (status.st_size < TRACE_HEADER) {
+        fprintf(stderr, "%s: not a trace file\n", path);
+        close(descriptor);
+        return -1;
+    }
+    void *mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);                                                                  // the mapping stays valid once the file is closed
+    if (mapping == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+    madvise(mapping, status.st_size, MADV_SEQUENTIAL);                                  // pages are only ever read front to back
+    const unsigned char *bytes = mapping;
+    uint64_t length = 0;                                                                // number of page numbers, little-endian
+    for (int i = 7; i >= 0; i--) { length = (length << 8) | bytes[8 + i]; }
+    if (memcmp(bytes, TRACE_MAGIC, 8) != 0 || length > (uint64_t) (status.st_size - TRACE_HEADER)) {
+        fprintf(stderr, "%s: not a trace file\n", path);                               // every page number takes at least one byte
+        munmap(mapping, status.st_size);
+        return -1;
+    }
+    trace->data = NULL;
+    trace->bytes = bytes;
+    trace->size = status.st_size;
+    trace->length = (long long) length;
+    rewindTrace(trace);
+    return 0;
+}
+
+/********************************************************************************************************************************************************
+* int readTrace (TraceSource *trace, const int **block, long long limit)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  points block at the next page numbers of the trace source and returns how many there are, at most TRACE_BLOCK and limit. Returns 0
+                once the trace is exhausted. Trace files are decoded into the source's own block, which the next read overwrites. Exits if the
+                trace file turns out to be truncated or holds a page number that does not fit an int
+* Parameters:
+*    trace - TraceSource* - trace source being read
+*    block - const int** - set to the page numbers read
+*    limit - long long - most page numbers wanted
+********************************************************************************************************************************************************/
+
+int readTrace(TraceSource *trace, const int **block, long long limit) {
+    long long count = trace->length - trace->position;                                  // page numbers left in the trace
+    if (count > limit) { count = limit; }
+    if (count > TRACE_BLOCK) { count = TRACE_BLOCK; }
+    if (count <= 0) { return 0; }
+    if (trace->data != NULL) {                                                          // in-memory trace, hand out the array itself
+        *block = trace->data + trace->position;
+        trace->position += count;
+        return (int) count;
+    }
+    for (int i = 0; i < count; i++) {                                                   // decode each page number of the block
+        uint64_t encoded = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {                                                                            // 7 bits per byte, high bit set on all but the last
+            if (trace->offset >= trace->size || shift > 63) {
+                fprintf(stderr, "readTrace: trace file is truncated or corrupt\n");
+                exit(1);
+            }
+            byte = trace->bytes[trace->offset++];
+            encoded |= (uint64_t) (byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        int64_t page = (int64_t) trace->previous + (int64_t) ((encoded >> 1) ^ -(encoded & 1));   // undo the zigzag encoding
+        if (page < INT_MIN || page > INT_MAX) {
+            fprintf(stderr, "readTrace: trace file holds a page number out of range\n");
+            exit(1);
+        }
+        trace->block[i] = trace->previous = (int) page;
+    }
+    trace->position += count;
+    *block = trace->block;
+    return (int) count;
+}
+
+/********************************************************************************************************************************************************
+* void rewindTrace (TraceSource *trace)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  moves the trace source back to its first page number, so the next replacement algorithm reads the same data set
+* Parameters:
+*    trace - TraceSource* - trace source being rewound
+********************************************************************************************************************************************************/
+
+void rewindTrace(TraceSource *trace) {
+    trace->position = 0;
+    trace->offset = TRACE_HEADER;
+    trace->previous = 0;
+}
+
+/********************************************************************************************************************************************************
+* void closeTrace (TraceSource *trace)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  releases the mapping of a trace file. Copies of the trace source must no longer be read
+* Parameters:
+*    trace - TraceSource* - trace source being closed
+********************************************************************************************************************************************************/
+
+void closeTrace(TraceSource *trace) {
+    if (trace->bytes != NULL) { munmap((void *) trace->bytes, trace->size); }
+    trace->bytes = NULL;
+    trace->data = NULL;
+}
+
+/********************************************************************************************************************************************************
+* int convertTrace (FILE *input, const char *path)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  reads whitespace-separated page numbers as text and writes them to a trace file in the format described by openTraceFile. The
+                page numbers are encoded as they are read, so captures of any length are converted without holding them in memory. Returns 0,
+                or -1 after reporting the problem
+* Parameters:
+*    input - FILE* - text the page numbers are read from
+*    path - const char* - path of the trace file being written
+********************************************************************************************************************************************************/
+
+int convertTrace(FILE *input, const char *path) {
+    FILE *output = fopen(path, "wb");
+    if (output == NULL) {
+        perror(path);
+        return -1;
+    }
+    unsigned char header[TRACE_HEADER] = {0};                                           // reference count is filled in once it is known
+    memcpy(header, TRACE_MAGIC, 8);
+    fwrite(header, 1, TRACE_HEADER, output);
+    uint64_t length = 0;
+    long long page;
+    int previous = 0;
+    while (fscanf(input, "%lld", &page) == 1) {                                         // encode every page number as it is read
+        if (page < INT_MIN || page > INT_MAX) {
+            fprintf(stderr, "convertTrace: page number %lld does not fit an int\n", page);
+            fclose(output);
+            return -1;
+        }
+        int64_t delta = page - previous;
+        uint64_t encoded = ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);          // zigzag, small negative differences stay small
+        do {
+            unsigned char byte = encoded & 0x7F;
+            encoded >>= 7;
+            fputc(encoded != 0 ? byte | 0x80 : byte, output);
+        } while (encoded != 0);
+        previous = (int) page;
+        length++;
+    }
+    int malformed = !feof(input);                                                       // conversion stopped before the end of the input
+    if (malformed) { fprintf(stderr, "convertTrace: input holds something other than page numbers\n"); }
+    for (int i = 0; i < 8; i++) { header[8 + i] = (unsigned char) (length >> (8 * i)); }
+    fseek(output, 8, SEEK_SET);                                                         // fill in the reference count
+    fwrite(header + 8, 1, 8, output);
+    if (fclose(output) != 0) {
+        perror(path);
+        return -1;
+    }
+    return malformed ? -1 : 0;
+}
+
+/********************************************************************************************************************************************************
+* void generateTrace (int *data, int length, LocalityModel *model, uint64_t seed, uint64_t trace)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  fills a whole data set with normally distributed page numbers in one batch. The uniform numbers come from the counter-based
+                Philox4x32-10 generator keyed by the seed, with the trace number and block index as the counter, so any trace can be generated
+                by any thread without carrying generator state. Counters are generated GENERATOR_LANES at a time and every block of 4 words
+                becomes two normals through the Box-Muller transform, both with AVX2 when the processor has it (the scalar loops give the same
+                numbers otherwise). The locality model shifts the mean by blockShift for every blockLength references, as the original
+                experiments did, so the mean only changes at the start of a field instead of being worked out for every page number
+* Parameters:
+*    data - int* - data set being filled
+*    length - int - number of page numbers in the data set
+*    model - LocalityModel* - mean, standard deviation and mean shift of the page numbers
+*    seed - uint64_t - seed of the whole run
+*    trace - uint64_t - number of the trace being generated
+********************************************************************************************************************************************************/
+
+void generateTrace(int *data, int length, LocalityModel *model, uint64_t seed, uint64_t trace) {
+    uint32_t words[GENERATOR_GROUPS * GENERATOR_LANES * 4];                             // Philox output, 4 words per block stored lane by lane
+    double normals[GENERATOR_GROUPS * GENERATOR_LANES * 2];                             // two normally distributed numbers per block, in order
+    int perGroup = 2 * GENERATOR_LANES;                                                 // page numbers made from one group of blocks
+    int field = 0;                                                                      // field of blockLength references the page number is in
+    int left = model->blockLength;                                                      // page numbers left in the field
+    double mean = model->mean;                                                          // number is scaled depending on the field it is located within
+    for (int start = 0; start < length; start += GENERATOR_GROUPS * perGroup) {         // generate the data set one batch of groups at a time
+        int groups = (length - start + perGroup - 1) / perGroup;
+        if (groups > GENERATOR_GROUPS) { groups = GENERATOR_GROUPS; }
+        uint64_t firstGroup = start / perGroup;
+#ifdef HAVE_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            philoxBlocksAVX2(words, groups, firstGroup, seed, trace);
+            boxMullerAVX2(words, groups, normals);
+        }
+        else {
+            philoxBlocks(words, groups, firstGroup, seed, trace);
+            boxMuller(words, groups, normals);
+        }
+#else
+        philoxBlocks(words, groups, firstGroup, seed, trace);
+        boxMuller(words, groups, normals);
+#endif
+        int count = length - start < groups * perGroup ? length - start : groups * perGroup;
+        for (int i = 0; i < count; i++) {
+            if (left == 0) {                                                            // next field starts, shift the mean
+                field++;
+                left = model->blockLength;
+                mean = model->mean + model->blockShift * field;
+            }
+            left--;
+            data[start + i] = mean + model->deviation * normals[i];
+        }
+    }
+}
+
+/********************************************************************************************************************************************************
+* void philoxBlocks (uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  generates groups of GENERATOR_LANES Philox4x32-10 blocks, one lane at a time. Block b uses the counter (b, trace) and the key
+                seed. Word j of lane l of a group is stored at index (group * 4 + j) * GENERATOR_LANES + l, the layout philoxBlocksAVX2 produces
+* Parameters:
+*    words - uint32_t* - receives 4 * GENERATOR_LANES words per group
+*    groups - int - number of groups to generate
+*    firstGroup - uint64_t - index of the first group within the trace
+*    seed - uint64_t - key of the generator
+*    trace - uint64_t - number of the trace, upper half of the counter
+********************************************************************************************************************************************************/
+
+void philoxBlocks(uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace) {
+    for (int group = 0; group < groups; group++) {
+        for (int lane = 0; lane < GENERATOR_LANES; lane++) {
+            uint64_t block = (firstGroup + group) * GENERATOR_LANES + lane;
+            uint32_t c[4] = { (uint32_t) block, (uint32_t) (block >> 32), (uint32_t) trace, (uint32_t) (trace >> 32) };
+            uint32_t k[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+            for (int round = 0; round < 10; round++) {                                  // 10 rounds of multiply, mix and key bump
+                uint64_t p0 = (uint64_t) PHILOX_M0 * c[0];
+                uint64_t p1 = (uint64_t) PHILOX_M1 * c[2];
+                uint32_t next[4] = { (uint32_t) (p1 >> 32) ^ c[1] ^ k[0], (uint32_t) p1, (uint32_t) (p0 >> 32) ^ c[3] ^ k[1], (uint32_t) p0 };
+                memcpy(c, next, sizeof(c));
+                k[0] += PHILOX_W0;
+                k[1] += PHILOX_W1;
+            }
+            for (int j = 0; j < 4; j++) { words[(group * 4 + j) * GENERATOR_LANES + lane] = c[j]; }
+        }
+    }
+}
+
+/********************************************************************************************************************************************************
+* void boxMuller (const uint32_t *words, int groups, double *normals)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  turns every block of groups of Philox blocks into two normally distributed numbers through the Box-Muller transform. The first
+                two words give a uniform number in (0, 1] whose logarithm sets the radius, the last two an angle in turns. The logarithm and
+                the sine and cosine are the fdlibm polynomial kernels rather than the math library, every step written so boxMullerAVX2 can
+                repeat it exactly: integers are only converted to doubles where the result is exact, the angle is reduced with integer
+                arithmetic to a quarter turn plus at most an eighth turn either side, and neither function lets the compiler fuse a multiply
+                and an add. The normals of block b are stored at 2 * b and 2 * b + 1
+* Parameters:
+*    words - const uint32_t* - Philox output, laid out as philoxBlocks stores it
+*    groups - int - number of groups of blocks
+*    normals - double* - receives 2 * GENERATOR_LANES numbers per group
+********************************************************************************************************************************************************/
+
+__attribute__((optimize("fp-contract=off")))
+void boxMuller(const uint32_t *words, int groups, double *normals) {
+    for (int group = 0; group < groups; group++) {
+        const uint32_t *w = &words[group * GENERATOR_LANES * 4];
+        for (int lane = 0; lane < GENERATOR_LANES; lane++) {
+            uint64_t first = ((uint64_t) w[lane] << 32) | w[GENERATOR_LANES + lane];
+            uint64_t second = ((uint64_t) w[2 * GENERATOR_LANES + lane] << 32) | w[3 * GENERATOR_LANES + lane];
+            double uniform = ((first >> 11) + 1) * 0x1.0p-53;                           // uniform in (0, 1], log is never taken of 0
+            uint64_t bits;
+            memcpy(&bits, &uniform, sizeof(bits));
+            uint64_t exponent = bits >> 52;                                             // biased exponent, the sign bit is clear
+            bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;              // mantissa in [1, 2)
+            if (bits > SQRT2_BITS) {                                                    // halve it into [sqrt(2) / 2, sqrt(2))
+                bits -= 0x0010000000000000ull;
+                exponent++;
+            }
+            double mantissa;
+            memcpy(&mantissa, &bits, sizeof(mantissa));
+            double e = (double) exponent - 1023;
+            double f = mantissa - 1;                                                    // log(uniform) = e ln 2 + log(1 + f)
+            double s = f / (2 + f);
+            double z = s * s;
+            double r = logCoefficients[6];
+            for (int i = 5; i >= 0; i--) { r = r * z + logCoefficients[i]; }
+            r = r * z;
+            double halfSquare = 0.5 * f * f;
+            double logarithm = e * LN2_HIGH - ((halfSquare - (s * (halfSquare + r) + e * LN2_LOW)) - f);
+            double radius = sqrt(-2 * logarithm);
+
+            uint64_t turn = second >> 11;                                               // angle in units of 2^-53 turns
+            uint64_t quadrant = (turn + (1ull << 50)) >> 51;                            // nearest quarter turn, 4 is a whole turn
+            int64_t offset = (int64_t) (turn - (quadrant << 51));                       // rest of the angle, at most an eighth turn either side
+            double x = (double) offset * (2 * M_PI * 0x1.0p-53);                        // in [-pi / 4, pi / 4]
+            z = x * x;
+            double sine = sinCoefficients[5];
+            for (int i = 4; i >= 0; i--) { sine = sine * z + sinCoefficients[i]; }
+            sine = x + z * x * sine;
+            double cosine = cosCoefficients[5];
+            for (int i = 4; i >= 0; i--) { cosine = cosine * z + cosCoefficients[i]; }
+            double halfZ = 0.5 * z;
+            double head = 1 - halfZ;                                                    // 1 - z / 2 rounded, its error is added back below
+            cosine = head + (((1 - head) - halfZ) + z * (z * cosine));
+            if (quadrant & 1) {                                                         // a quarter turn more swaps them
+                double swap = sine;
+                sine = cosine;
+                cosine = -swap;
+            }
+            if (quadrant & 2) {                                                         // half a turn more flips both signs
+                sine = -sine;
+                cosine = -cosine;
+            }
+            normals[2 * (group * GENERATOR_LANES + lane)] = radius * cosine;
+            normals[2 * (group * GENERATOR_LANES + lane) + 1] = radius * sine;
+        }
+    }
+}
+
+#ifdef HAVE_AVX2
+/********************************************************************************************************************************************************
+* void philoxBlocksAVX2 (uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  generates the same blocks as philoxBlocks with every lane of a group in one AVX2 register per counter word. The 32x32 bit
+                products are formed separately for the even and odd lanes and their halves blended back together. Only called once the
+                processor is known to support AVX2
+* Parameters:
+*    words - uint32_t* - receives 4 * GENERATOR_LANES words per group
+*    groups - int - number of groups to generate
+*    firstGroup - uint64_t - index of the first group within the trace
+*    seed - uint64_t - key of the generator
+*    trace - uint64_t - number of the trace, upper half of the counter
+********************************************************************************************************************************************************/
+
+__attribute__((target("avx2")))
+void philoxBlocksAVX2(uint32_t *words, int groups, uint64_t firstGroup, uint64_t seed, uint64_t trace) {
+    const __m256i m0 = _mm256_set1_epi32((int) PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi32((int) PHILOX_M1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int group = 0; group < groups; group++) {
+        uint64_t block = (firstGroup + group) * GENERATOR_LANES;                        // block of lane 0, a multiple of 8 so lanes never carry
+        __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int) (uint32_t) block), lanes);
+        __m256i c1 = _mm256_set1_epi32((int) (uint32_t) (block >> 32));
+        __m256i c2 = _mm256_set1_epi32((int) (uint32_t) trace);
+        __m256i c3 = _mm256_set1_epi32((int) (uint32_t) (trace >> 32));
+        uint32_t k0 = (uint32_t) seed;
+        uint32_t k1 = (uint32_t) (seed >> 32);
+        for (int round = 0; round < 10; round++) {
+            __m256i even0 = _mm256_mul_epu32(c0, m0);                                   // 64 bit products of lanes 0, 2, 4, 6
+            __m256i odd0 = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), m0);             // 64 bit products of lanes 1, 3, 5, 7
+            __m256i even1 = _mm256_mul_epu32(c2, m1);
+            __m256i odd1 = _mm256_mul_epu32(_mm256_srli_epi64(c2, 32), m1);
+            __m256i low0 = _mm256_blend_epi32(even0, _mm256_slli_epi64(odd0, 32), 0xAA);
+            __m256i high0 = _mm256_blend_epi32(_mm256_srli_epi64(even0, 32), odd0, 0xAA);
+            __m256i low1 = _mm256_blend_epi32(even1, _mm256_slli_epi64(odd1, 32), 0xAA);
+            __m256i high1 = _mm256_blend_epi32(_mm256_srli_epi64(even1, 32), odd1, 0xAA);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(high1, c1), _mm256_set1_epi32((int) k0));
+            c1 = low1;
+            c2 = _mm256_xor_si256(_mm256_xor_si256(high0, c3), _mm256_set1_epi32((int) k1));
+            c3 = low0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        __m256i *out = (__m256i *) &words[group * 4 * GENERATOR_LANES];
+        _mm256_storeu_si256(out, c0);
+        _mm256_storeu_si256(out + 1, c1);
+        _mm256_storeu_si256(out + 2, c2);
+        _mm256_storeu_si256(out + 3, c3);
+    }
+}
+
+/********************************************************************************************************************************************************
+* void boxMullerAVX2 (const uint32_t *words, int groups, double *normals)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  turns the blocks into the same normally distributed numbers as boxMuller, four lanes of a group at a time. Every operation of
+                the scalar loop is repeated in the same order, the 53 bit uniform integer is converted through its two 32 bit halves and the
+                small integers through the bits of 2^52 so no conversion rounds, and the quadrant swap and sign flips become a blend and
+                exclusive ors. Only called once the processor is known to support AVX2
+* Parameters:
+*    words - const uint32_t* - Philox output, laid out as philoxBlocks stores it
+*    groups - int - number of groups of blocks
+*    normals - double* - receives 2 * GENERATOR_LANES numbers per group
+********************************************************************************************************************************************************/
+
+__attribute__((target("avx2"), optimize("fp-contract=off")))
+void boxMullerAVX2(const uint32_t *words, int groups, double *normals) {
+    const __m256i exponentBits = _mm256_set1_epi64x(0x4330000000000000ll);              // bits of 2^52, small integers are added to its mantissa
+    const __m256i offsetBits = _mm256_set1_epi64x(0x4338000000000000ll);                // bits of 1.5 * 2^52, signed ones too
+    const __m256d exponentBase = _mm256_set1_pd(0x1.0p52);
+    const __m256d offsetBase = _mm256_set1_pd(0x1.8p52);
+    const __m256i lowHalf = _mm256_set1_epi64x(0xFFFFFFFFll);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i two = _mm256_set1_epi64x(2);
+    const __m256d unit = _mm256_set1_pd(1);
+    for (int group = 0; group < groups; group++) {
+        for (int half = 0; half < GENERATOR_LANES; half += 4) {
+            const uint32_t *w = &words[group * GENERATOR_LANES * 4 + half];
+            __m256i word0 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) w));
+            __m256i word1 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) (w + GENERATOR_LANES)));
+            __m256i word2 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) (w + 2 * GENERATOR_LANES)));
+            __m256i word3 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) (w + 3 * GENERATOR_LANES)));
+            __m256i first = _mm256_or_si256(_mm256_slli_epi64(word0, 32), word1);
+            __m256i second = _mm256_or_si256(_mm256_slli_epi64(word2, 32), word3);
+
+            __m256i integer = _mm256_add_epi64(_mm256_srli_epi64(first, 11), one);
+            __m256d high = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(integer, 32), exponentBits)), exponentBase);
+            __m256d low = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(integer, lowHalf), exponentBits)), exponentBase);
+            __m256d uniform = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(high, _mm256_set1_pd(0x1.0p32)), low), _mm256_set1_pd(0x1.0p-53));
+            __m256i bits = _mm256_castpd_si256(uniform);
+            __m256i exponent = _mm256_srli_epi64(bits, 52);
+            bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)), _mm256_set1_epi64x(0x3FF0000000000000ll));
+            __m256i halve = _mm256_cmpgt_epi64(bits, _mm256_set1_epi64x((long long) SQRT2_BITS));   // all ones where the mantissa is halved
+            bits = _mm256_sub_epi64(bits, _mm256_and_si256(halve, _mm256_set1_epi64x(0x0010000000000000ll)));
+            exponent = _mm256_sub_epi64(exponent, halve);
+            __m256d e = _mm256_sub_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(exponent, exponentBits)), exponentBase),
+                                      _mm256_set1_pd(1023));
+            __m256d f = _mm256_sub_pd(_mm256_castsi256_pd(bits), unit);
+            __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2), f));
+            __m256d z = _mm256_mul_pd(s, s);
+            __m256d r = _mm256_set1_pd(logCoefficients[6]);
+            for (int i = 5; i >= 0; i--) { r = _mm256_add_pd(_mm256_mul_pd(r, z), _mm256_set1_pd(logCoefficients[i])); }
+            r = _mm256_mul_pd(r, z);
+            __m256d halfSquare = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), f), f);
+            __m256d inner = _mm256_add_pd(_mm256_mul_pd(s, _mm256_add_pd(halfSquare, r)), _mm256_mul_pd(e, _mm256_set1_pd(LN2_LOW)));
+            __m256d logarithm = _mm256_sub_pd(_mm256_mul_pd(e, _mm256_set1_pd(LN2_HIGH)), _mm256_sub_pd(_mm256_sub_pd(halfSquare, inner), f));
+            __m256d radius = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(-2), logarithm));
+
+            __m256i turn = _mm256_srli_epi64(second, 11);
+            __m256i quadrant = _mm256_srli_epi64(_mm256_add_epi64(turn, _mm256_set1_epi64x(1ll << 50)), 51);
+            __m256i offset = _mm256_sub_epi64(turn, _mm256_slli_epi64(quadrant, 51));
+            __m256d x = _mm256_mul_pd(_mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(offset, offsetBits)), offsetBase),
+                                      _mm256_set1_pd(2 * M_PI * 0x1.0p-53));
+            z = _mm256_mul_pd(x, x);
+            __m256d sine = _mm256_set1_pd(sinCoefficients[5]);
+            for (int i = 4; i >= 0; i--) { sine = _mm256_add_pd(_mm256_mul_pd(sine, z), _mm256_set1_pd(sinCoefficients[i])); }
+            sine = _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(z, x), sine));
+            __m256d cosine = _mm256_set1_pd(cosCoefficients[5]);
+            for (int i = 4; i >= 0; i--) { cosine = _mm256_add_pd(_mm256_mul_pd(cosine, z), _mm256_set1_pd(cosCoefficients[i])); }
+            __m256d halfZ = _mm256_mul_pd(_mm256_set1_pd(0.5), z);
+            __m256d head = _mm256_sub_pd(unit, halfZ);
+            cosine = _mm256_add_pd(head, _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(unit, head), halfZ), _mm256_mul_pd(z, _mm256_mul_pd(z, cosine))));
+            __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+            __m256d swappedSine = _mm256_blendv_pd(sine, cosine, swap);
+            __m256d swappedCosine = _mm256_blendv_pd(cosine, sine, swap);
+            __m256i sineSign = _mm256_slli_epi64(_mm256_and_si256(quadrant, two), 62);  // half a turn more flips both signs,
+            __m256i cosineSign = _mm256_xor_si256(sineSign, _mm256_slli_epi64(quadrant, 63));   // a quarter turn more the swapped sine's too
+            sine = _mm256_xor_pd(swappedSine, _mm256_castsi256_pd(sineSign));
+            cosine = _mm256_xor_pd(swappedCosine, _mm256_castsi256_pd(cosineSign));
+
+            __m256d cosines = _mm256_mul_pd(radius, cosine);                            // normals of lanes 0 to 3, cosine first
+            __m256d sines = _mm256_mul_pd(radius, sine);
+            __m256d even = _mm256_unpacklo_pd(cosines, sines);                          // lanes 0 and 2
+            __m256d odd = _mm256_unpackhi_pd(cosines, sines);                           // lanes 1 and 3
+            double *out = &normals[2 * (group * GENERATOR_LANES + half)];
+            _mm256_storeu_pd(out, _mm256_permute2f128_pd(even, odd, 0x20));
+            _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(even, odd, 0x31));
+        }
+    }
+}
+#endif
+
+#ifdef INSTRUMENT
+/********************************************************************************************************************************************************
+* void startPass (void)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  forgets every page the calling thread has seen, so the misses of a policy that starts reading a trace from the front are classed
+                as compulsory or capacity misses by that pass alone
+* Parameters:
+*    none
+********************************************************************************************************************************************************/
+
+void startPass(void) {
+    if (counters == NULL) { return; }
+    freePageTable(&counters->seen);
+    if (createPageTable(&counters->seen, TRACE_BLOCK) != 0) {
+        fprintf(stderr, "startPass: out of memory\n");
+        exit(1);
+    }
+}
+
+/********************************************************************************************************************************************************
+* void markReference (int page)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  sets the calling thread's firstReference flag if the page has not been seen in the current pass and remembers it. The lookups go
+                to the instrumentation's own table with counting paused, so they never show up in the probe counts
+* Parameters:
+*    page - int - page number being read
+********************************************************************************************************************************************************/
+
+void markReference(int page) {
+    Counters *current = counters;
+    if (current == NULL) { return; }
+    counters = NULL;                                                                    // pause counting while the seen table is probed
+    current->firstReference = findPage(&current->seen, page) == NULL;
+    if (current->firstReference) { insertPage(&current->seen, page, 0); }
+    counters = current;
+}
+
+/********************************************************************************************************************************************************
+* void countProbes (long long length)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  adds a lookup of the given probe length to the calling thread's probe counts
+* Parameters:
+*    length - long long - number of slots the lookup probed
+********************************************************************************************************************************************************/
+
+void countProbes(long long length) {
+    if (counters == NULL) { return; }
+    counters->lookups++;
+    counters->probes += length;
+    counters->probeLengths[length < PROBE_BUCKETS ? length : PROBE_BUCKETS - 1]++;
+    if (length > counters->longestProbe) { counters->longestProbe = length; }
+}
+
+/********************************************************************************************************************************************************
+* unsigned long long readCycles (void)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  returns the processor's time stamp counter, or the monotonic clock in nanoseconds where rdtsc is not available
+* Parameters:
+*    none
+********************************************************************************************************************************************************/
+
+unsigned long long readCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+/********************************************************************************************************************************************************
+* void addCounters (Counters *total, Counters *thread)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  adds every count of a thread's counters to the total, keeping the larger of the longest probe and sweep lengths
+* Parameters:
+*    total - Counters* - counters being added to
+*    thread - Counters* - counters of one thread
+********************************************************************************************************************************************************/
+
+void addCounters(Counters *total, Counters *thread) {
+    for (int policy = 0; policy < POLICIES; policy++) {
+        total->hits[policy] += thread->hits[policy];
+        total->faults[policy] += thread->faults[policy];
+        total->compulsory[policy] += thread->compulsory[policy];
+        total->capacity[policy] += thread->capacity[policy];
+    }
+    total->lookups += thread->lookups;
+    total->probes += thread->probes;
+    if (thread->longestProbe > total->longestProbe) { total->longestProbe = thread->longestProbe; }
+    for (int length = 0; length < PROBE_BUCKETS; length++) { total->probeLengths[length] += thread->probeLengths[length]; }
+    total->sweeps += thread->sweeps;
+    total->sweepSteps += thread->sweepSteps;
+    if (thread->longestSweep > total->longestSweep) { total->longestSweep = thread->longestSweep; }
+    for (int phase = 0; phase < PHASES; phase++) {
+        total->cycles[phase] += thread->cycles[phase];
+        total->phaseRuns[phase] += thread->phaseRuns[phase];
+    }
+}
+
+/********************************************************************************************************************************************************
+* void dumpCounters (FILE *output, Counters *thread)
+* Author: Anton Horvath
+* Date: 16 October 2026
+* Description:  outputs the counters as one JSON object, the hits, faults, compulsory and capacity misses of every policy, the page table probe
+                lengths, the clock sweep lengths and the runs and cycles of every phase. The stack policy is the stack distance pass, its hits
+                are re-references and its compulsory misses first references, as an unbounded working set would see them
+* Parameters:
+*    output - FILE* - stream the object is written to
+*    thread - Counters* - counters being output
+********************************************************************************************************************************************************/
+
+void dumpCounters(FILE *output, Counters *thread) {
+    fprintf(output, "{\"policies\": {");
+    for (int policy = 0; policy < POLICIES; policy++) {
+        fprintf(output, "%s\"%s\": {\"hits\": %lld, \"faults\": %lld, \"compulsory\": %lld, \"capacity\": %lld}", policy > 0 ? ", " : "",
+                policyNames[policy], thread->hits[policy], thread->faults[policy], thread->compulsory[policy], thread->capacity[policy]);
+    }
+    fprintf(output, "}, \"probes\": {\"lookups\": %lld, \"total\": %lld, \"longest\": %lld, \"lengths\": [",
+            thread->lookups, thread->probes, thread->longestProbe);
+    for (int length = 1; length < PROBE_BUCKETS; length++) {                            // probe lengths start at 1, bucket 0 stays empty
+        fprintf(output, "%s%lld", length > 1 ? ", " : "", thread->probeLengths[length]);
+    }
+    fprintf(output, "]}, \"sweeps\": {\"count\": %lld, \"steps\": %lld, \"longest\": %lld}, \"phases\": {",
+            thread->sweeps, thread->sweepSteps, thread->longestSweep);
+    for (int phase = 0; phase < PHASES; phase++) {
+        fprintf(output, "%s\"%s\": {\"runs\": %lld, \"cycles\": %llu}", phase > 0 ? ", " : "", phaseNames[phase], thread->phaseRuns[phase],
+                thread->cycles[phase]);
+    }
+    fprintf(output, "}}");
 }
+#endif